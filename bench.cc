@@ -0,0 +1,373 @@
+// bench measures the throughput of wuffs_base__parse_number_f64 over a set of
+// synthetic corpora, next to the C library's strtod and (where available)
+// C++17's std::from_chars.
+//
+// Usage: bench [num_values [corpus ...]]
+//
+// Each corpus has num_values (default 100000) numbers, generated from a fixed
+// seed so that runs are comparable:
+//  - uniform:   random doubles in [0, 1), as printf("%.17g") renders them.
+//  - canada:    longitude/latitude pairs in their shortest round-trip form,
+//               like the coordinates in canada.json.
+//  - mesh:      3D vertex coordinates with 7 significant digits.
+//  - integers:  short integers in [0, 100000).
+//  - repr17:    random finite bit patterns, as printf("%.17g") renders them.
+//  - longdigit: 20 to 60 digit mantissas, which need more than the 19 digits
+//               that fit in a uint64_t.
+//  - subnormal: random subnormal bit patterns, as printf("%.17g") renders
+//               them.
+//
+// For each corpus and parser it prints MB/s (of number bytes, not counting
+// separators), ns/number and, if the Linux perf_event_open hardware counters
+// are available, instructions/number. It also checks that the parsers agree
+// bit for bit, and exits with a non-zero status if they don't.
+//
+// Build with: c++ -std=c++17 -O2 bench.cc -o bench
+
+#include "wuffs_eisel_lemire.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __cpp_lib_to_chars
+#define BENCH_HAVE_FROM_CHARS 1
+#else
+#define BENCH_HAVE_FROM_CHARS 0
+#endif
+
+#define BENCH_NUM_TRIALS 5
+
+struct bench_corpus
+{
+ const char *name;
+ std::vector<char> text;
+ std::vector<wuffs_base__slice_u8> numbers;
+ size_t num_bytes;
+};
+
+static uint64_t bench_rng_state = 0x9E3779B97F4A7C15;
+
+static uint64_t
+bench_rng(void)
+{
+ // xorshift64*
+ bench_rng_state ^= bench_rng_state >> 12;
+ bench_rng_state ^= bench_rng_state << 25;
+ bench_rng_state ^= bench_rng_state >> 27;
+ return bench_rng_state * 0x2545F4914F6CDD1D;
+}
+
+static double
+bench_rng_unit(void)
+{
+ return (double)(bench_rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double
+bench_now(void)
+{
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+// bench_generate_one writes the i'th number of the named corpus to buf and
+// returns its length.
+static int
+bench_generate_one(const char *name, size_t i, char *buf, size_t buf_len)
+{
+ if (!strcmp(name, "uniform"))
+ {
+  return snprintf(buf, buf_len, "%.17g", bench_rng_unit());
+ }
+ else if (!strcmp(name, "canada"))
+ {
+  double x = (i & 1) ? ((bench_rng_unit() * 180.0) - 90.0) : ((bench_rng_unit() * 360.0) - 180.0);
+  return (int)wuffs_double_to_str(buf, buf_len, x);
+ }
+ else if (!strcmp(name, "mesh"))
+ {
+  return snprintf(buf, buf_len, "%.7g", (bench_rng_unit() * 20.0) - 10.0);
+ }
+ else if (!strcmp(name, "integers"))
+ {
+  return snprintf(buf, buf_len, "%d", (int)(bench_rng() % 100000));
+ }
+ else if (!strcmp(name, "repr17") || !strcmp(name, "subnormal"))
+ {
+  double x;
+  do
+  {
+   uint64_t u = bench_rng();
+   if (name[0] == 's')
+   {
+    u &= 0x800FFFFFFFFFFFFF;
+   }
+   x = wuffs_base__ieee_754_bit_representation__from_u64_to_f64(u);
+  } while ((x != x) || ((x - x) != 0));
+  return snprintf(buf, buf_len, "%.17g", x);
+ }
+ else if (!strcmp(name, "longdigit"))
+ {
+  int n = 20 + (int)(bench_rng() % 41);
+  int dot = 1 + (int)(bench_rng() % n);
+  int len = 0;
+  for (int j = 0; j < n; j++)
+  {
+   if (j == dot)
+   {
+    buf[len++] = '.';
+   }
+   buf[len++] = (char)('0' + ((j == 0) ? (1 + (bench_rng() % 9)) : (bench_rng() % 10)));
+  }
+  return len + snprintf(buf + len, buf_len - len, "e%d", (int)(bench_rng() % 600) - 300);
+ }
+ return -1;
+}
+
+static bool
+bench_generate(bench_corpus *c, const char *name, size_t num_values)
+{
+ char buf[128];
+ c->name = name;
+ c->num_bytes = 0;
+ std::vector<size_t> offsets;
+ for (size_t i = 0; i < num_values; i++)
+ {
+  int n = bench_generate_one(name, i, buf, sizeof(buf));
+  if (n < 0)
+  {
+   return false;
+  }
+  offsets.push_back(c->text.size());
+  c->text.insert(c->text.end(), buf, buf + n);
+  c->text.push_back('\n');
+  c->num_bytes += (size_t)n;
+ }
+ // Take the pointers after text stops growing.
+ for (size_t i = 0; i < num_values; i++)
+ {
+  size_t end = (i + 1 < num_values) ? (offsets[i + 1] - 1) : (c->text.size() - 1);
+  wuffs_base__slice_u8 s = {.ptr = (uint8_t *)&c->text[offsets[i]], .len = end - offsets[i]};
+  c->numbers.push_back(s);
+ }
+ return true;
+}
+
+// ---------------- Instruction Counting
+
+static int bench_perf_fd = -1;
+
+static void
+bench_perf_open(void)
+{
+#ifdef __linux__
+ struct perf_event_attr attr;
+ memset(&attr, 0, sizeof(attr));
+ attr.type = PERF_TYPE_HARDWARE;
+ attr.size = sizeof(attr);
+ attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+ attr.disabled = 1;
+ attr.exclude_kernel = 1;
+ attr.exclude_hv = 1;
+ bench_perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+static void
+bench_perf_start(void)
+{
+#ifdef __linux__
+ if (bench_perf_fd >= 0)
+ {
+  ioctl(bench_perf_fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(bench_perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+ }
+#endif
+}
+
+// bench_perf_stop returns the number of instructions since bench_perf_start,
+// or -1 if they aren't available.
+static double
+bench_perf_stop(void)
+{
+#ifdef __linux__
+ if (bench_perf_fd >= 0)
+ {
+  ioctl(bench_perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+  uint64_t n = 0;
+  if (read(bench_perf_fd, &n, sizeof(n)) == (ssize_t)sizeof(n))
+  {
+   return (double)n;
+  }
+ }
+#endif
+ return -1;
+}
+
+// ---------------- Parsers
+
+static bool
+bench_parse_wuffs(const wuffs_base__slice_u8 *numbers, size_t n, double *dst)
+{
+ bool ok = true;
+ for (size_t i = 0; i < n; i++)
+ {
+  wuffs_base__result_f64 r = wuffs_base__parse_number_f64(numbers[i], 0);
+  dst[i] = r.value;
+  ok &= !r.status.repr;
+ }
+ return ok;
+}
+
+static bool
+bench_parse_strtod(const wuffs_base__slice_u8 *numbers, size_t n, double *dst)
+{
+ // Every number is followed by a '\n', which stops strtod.
+ bool ok = true;
+ for (size_t i = 0; i < n; i++)
+ {
+  char *end;
+  dst[i] = strtod((const char *)numbers[i].ptr, &end);
+  ok &= (end == (char *)(numbers[i].ptr + numbers[i].len));
+ }
+ return ok;
+}
+
+#if BENCH_HAVE_FROM_CHARS
+static bool
+bench_parse_from_chars(const wuffs_base__slice_u8 *numbers, size_t n, double *dst)
+{
+ bool ok = true;
+ for (size_t i = 0; i < n; i++)
+ {
+  const char *p = (const char *)numbers[i].ptr;
+  const char *q = p + numbers[i].len;
+  std::from_chars_result r = std::from_chars(p, q, dst[i]);
+  ok &= (r.ec == std::errc()) && (r.ptr == q);
+ }
+ return ok;
+}
+#endif
+
+struct bench_parser
+{
+ const char *name;
+ bool (*parse)(const wuffs_base__slice_u8 *numbers, size_t n, double *dst);
+};
+
+static const bench_parser bench_parsers[] = {
+    {"wuffs", bench_parse_wuffs},
+    {"strtod", bench_parse_strtod},
+#if BENCH_HAVE_FROM_CHARS
+    {"from_chars", bench_parse_from_chars},
+#endif
+};
+
+#define BENCH_NUM_PARSERS (sizeof(bench_parsers) / sizeof(bench_parsers[0]))
+
+static const char *bench_corpus_names[] = {
+    "uniform", "canada", "mesh", "integers", "repr17", "longdigit", "subnormal",
+};
+
+// bench_run parses c with p BENCH_NUM_TRIALS times and prints the fastest
+// trial. It returns whether the output matched expected (if non-NULL).
+static bool
+bench_run(const bench_corpus *c, const bench_parser *p, double *dst, const double *expected)
+{
+ size_t n = c->numbers.size();
+ double best_secs = 1e300;
+ double best_instructions = -1;
+ bool ok = true;
+ for (int trial = 0; trial < BENCH_NUM_TRIALS; trial++)
+ {
+  double start = bench_now();
+  bench_perf_start();
+  ok = (*p->parse)(c->numbers.data(), n, dst);
+  double instructions = bench_perf_stop();
+  double secs = bench_now() - start;
+  if (secs < best_secs)
+  {
+   best_secs = secs;
+   best_instructions = instructions;
+  }
+ }
+ if (best_secs <= 0)
+ {
+  best_secs = 1e-9;
+ }
+
+ char ins[32] = "-";
+ if (best_instructions >= 0)
+ {
+  snprintf(ins, sizeof(ins), "%.1f", best_instructions / (double)n);
+ }
+ printf("%-10s %-11s %9.1f %9.2f %9s%s\n", c->name, p->name,
+        (double)c->num_bytes / best_secs / 1e6, best_secs * 1e9 / (double)n, ins,
+        ok ? "" : "  (some inputs rejected)");
+
+ // A parser that rejected some inputs (such as from_chars, on underflow or
+ // overflow) may have left their dst elements alone, so don't compare.
+ if (ok && expected && memcmp(dst, expected, n * sizeof(double)))
+ {
+  printf("%-10s %-11s MISMATCH with %s\n", c->name, p->name, bench_parsers[0].name);
+  return false;
+ }
+ return true;
+}
+
+int main(int argc, char **argv)
+{
+ size_t num_values = 100000;
+ if (argc > 1)
+ {
+  num_values = strtoul(argv[1], NULL, 10);
+  if (num_values == 0)
+  {
+   fprintf(stderr, "usage: %s [num_values [corpus ...]]\n", argv[0]);
+   return 2;
+  }
+ }
+ std::vector<const char *> names;
+ for (int i = 2; i < argc; i++)
+ {
+  names.push_back(argv[i]);
+ }
+ if (names.empty())
+ {
+  names.assign(bench_corpus_names, bench_corpus_names + (sizeof(bench_corpus_names) / sizeof(bench_corpus_names[0])));
+ }
+
+ bench_perf_open();
+ printf("%-10s %-11s %9s %9s %9s\n", "corpus", "parser", "MB/s", "ns/num", "ins/num");
+ int ret = 0;
+ for (const char *name : names)
+ {
+  bench_corpus c;
+  if (!bench_generate(&c, name, num_values))
+  {
+   fprintf(stderr, "unknown corpus: %s\n", name);
+   return 2;
+  }
+  std::vector<double> expected(num_values);
+  std::vector<double> dst(num_values);
+  for (size_t i = 0; i < BENCH_NUM_PARSERS; i++)
+  {
+   if (!bench_run(&c, &bench_parsers[i], (i == 0) ? expected.data() : dst.data(), (i == 0) ? NULL : expected.data()))
+   {
+    ret = 1;
+   }
+  }
+ }
+ return ret;
+}
@@ -0,0 +1,361 @@
+// exhaustive checks wuffs_base__parse_number_f64 (and _f32) against known
+// answers, over every float32 value and dense samples of the double range,
+// using every core.
+//
+// Usage: exhaustive [-j num_threads] [-s f32_stride] [-w ulps] [-h ulps]
+//
+// The float32 sweep visits every stride'th bit pattern (by default, all 2**32
+// of them), skipping NaNs. Each value x is:
+//  - rendered with printf's "%.17g" and with wuffs_base__render_number_f64's
+//    shortest form, both of which must parse back to exactly (double)x.
+//  - rendered with "%.9g", which must parse (as an f32) back to exactly x and
+//    (as an f64) to the same bits as the C library's strtod.
+//
+// The double sweep visits the w (default 10000) doubles either side of every
+// power of 10 from 1e-324 to 1e+308, of the subnormal/normal boundary, of the
+// smallest subnormal and of the largest finite double. Each is rendered with
+// "%.17g" and the shortest form (which must round-trip) and with "%.15g" and
+// "%.16g" (which must match strtod). The h (default 50) doubles either side of
+// each of those points also have their exact halfway point to the next double
+// rendered in full (hundreds of digits), which must round to even, and that
+// halfway point nudged up or down by a tiny amount, which must round up or
+// down.
+//
+// It prints the first few failures and a summary, and exits non-zero if there
+// were any failures.
+//
+// Build with: cc -O2 -pthread exhaustive.c -o exhaustive
+
+#include "wuffs_eisel_lemire_parallel.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Each float32 chunk covers this many bit patterns (before the stride).
+#define EXHAUSTIVE_F32_CHUNK_LEN ((uint64_t)1 << 22)
+
+// The doubles are checked around these points (plus each power of 10).
+static const uint64_t exhaustive_f64_points[] = {
+    0x0000000000000000, // Zero (and the smallest subnormals above it).
+    0x0010000000000000, // The smallest normal.
+    0x7FEFFFFFFFFFFFFF, // The largest finite.
+};
+
+#define EXHAUSTIVE_NUM_F64_POINTS (sizeof(exhaustive_f64_points) / sizeof(exhaustive_f64_points[0]))
+#define EXHAUSTIVE_MIN_POW10 (-324)
+#define EXHAUSTIVE_MAX_POW10 (+308)
+
+typedef struct
+{
+ uint64_t f32_stride;
+ int64_t width;
+ int64_t halfway_width;
+
+ uint64_t num_checks;
+ uint64_t num_failures;
+ pthread_mutex_t print_mutex;
+} exhaustive_context;
+
+static double
+exhaustive_now(void)
+{
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+static void
+exhaustive_fail(exhaustive_context *c, const char *what, const char *s, uint64_t got, uint64_t want)
+{
+ uint64_t n = __atomic_fetch_add(&c->num_failures, 1, __ATOMIC_RELAXED);
+ if (n < 20)
+ {
+  pthread_mutex_lock(&c->print_mutex);
+  printf("FAIL %s: \"%.60s%s\": got 0x%016llX, want 0x%016llX\n", what, s, (strlen(s) > 60) ? "..." : "",
+         (unsigned long long)got, (unsigned long long)want);
+  pthread_mutex_unlock(&c->print_mutex);
+ }
+}
+
+// exhaustive_check_f64 parses s and compares the result with want, bit for
+// bit. It returns 1, the number of checks made.
+static uint64_t
+exhaustive_check_f64(exhaustive_context *c, const char *what, const char *s, double want)
+{
+ wuffs_base__slice_u8 slice = {.ptr = (uint8_t *)s, .len = strlen(s)};
+ wuffs_base__result_f64 r = wuffs_base__parse_number_f64(slice, 0);
+ uint64_t got_bits = wuffs_base__ieee_754_bit_representation__from_f64_to_u64(r.value);
+ uint64_t want_bits = wuffs_base__ieee_754_bit_representation__from_f64_to_u64(want);
+ if (r.status.repr || (got_bits != want_bits))
+ {
+  exhaustive_fail(c, what, s, got_bits, want_bits);
+ }
+ return 1;
+}
+
+// exhaustive_check_round_trips checks x's "%.17g" and shortest forms, which
+// must both parse back to x, and its "%.15g" and "%.16g" forms, which must
+// parse to the same as strtod. It returns the number of checks made.
+static uint64_t
+exhaustive_check_round_trips(exhaustive_context *c, double x, bool lower_precisions)
+{
+ char buf[64];
+ snprintf(buf, sizeof(buf), "%.17g", x);
+ exhaustive_check_f64(c, "%.17g", buf, x);
+ size_t n = wuffs_double_to_str(buf, sizeof(buf) - 1, x);
+ buf[n] = '\0';
+ exhaustive_check_f64(c, "shortest", buf, x);
+ if (!lower_precisions)
+ {
+  return 2;
+ }
+ snprintf(buf, sizeof(buf), "%.15g", x);
+ exhaustive_check_f64(c, "%.15g", buf, strtod(buf, NULL));
+ snprintf(buf, sizeof(buf), "%.16g", x);
+ exhaustive_check_f64(c, "%.16g", buf, strtod(buf, NULL));
+ return 4;
+}
+
+// ---------------- Float32 Sweep
+
+static void
+exhaustive_f32_chunk(wuffs_private_impl__parallel__job *job, size_t i)
+{
+ exhaustive_context *c = (exhaustive_context *)job->context;
+ uint64_t num_checks = 0;
+ uint64_t lo = (uint64_t)i * EXHAUSTIVE_F32_CHUNK_LEN * c->f32_stride;
+ uint64_t hi = lo + (EXHAUSTIVE_F32_CHUNK_LEN * c->f32_stride);
+ if (hi > ((uint64_t)1 << 32))
+ {
+  hi = (uint64_t)1 << 32;
+ }
+ char buf[64];
+ for (uint64_t bits = lo; bits < hi; bits += c->f32_stride)
+ {
+  float f = wuffs_base__ieee_754_bit_representation__from_u32_to_f32((uint32_t)bits);
+  if (f != f)
+  {
+   continue;
+  }
+  double x = (double)f;
+  num_checks += exhaustive_check_round_trips(c, x, false);
+
+  snprintf(buf, sizeof(buf), "%.9g", x);
+  wuffs_base__slice_u8 slice = {.ptr = (uint8_t *)buf, .len = strlen(buf)};
+  wuffs_base__result_f32 r = wuffs_base__parse_number_f32(slice, 0);
+  uint32_t got;
+  memcpy(&got, &r.value, sizeof(got));
+  if (r.status.repr || (got != (uint32_t)bits))
+  {
+   exhaustive_fail(c, "%.9g (f32)", buf, got, bits);
+  }
+  exhaustive_check_f64(c, "%.9g", buf, strtod(buf, NULL));
+  num_checks += 2;
+ }
+ __atomic_fetch_add(&c->num_checks, num_checks, __ATOMIC_RELAXED);
+}
+
+// ---------------- Double Sweep
+
+// exhaustive_bignum is a non-negative integer in base 1e9, least significant
+// limb first. 1e9 ** 90 is more than 2 ** 2100, enough for any halfway point.
+typedef struct
+{
+ uint32_t limbs[90];
+ int num_limbs;
+} exhaustive_bignum;
+
+static void
+exhaustive_bignum_mul(exhaustive_bignum *b, uint32_t m)
+{
+ uint64_t carry = 0;
+ for (int i = 0; i < b->num_limbs; i++)
+ {
+  uint64_t v = ((uint64_t)b->limbs[i] * m) + carry;
+  b->limbs[i] = (uint32_t)(v % 1000000000);
+  carry = v / 1000000000;
+ }
+ while (carry)
+ {
+  b->limbs[b->num_limbs++] = (uint32_t)(carry % 1000000000);
+  carry /= 1000000000;
+ }
+}
+
+// exhaustive_bignum_decrement subtracts 1 from a non-zero b.
+static void
+exhaustive_bignum_decrement(exhaustive_bignum *b)
+{
+ for (int i = 0; i < b->num_limbs; i++)
+ {
+  if (b->limbs[i] > 0)
+  {
+   b->limbs[i]--;
+   break;
+  }
+  b->limbs[i] = 999999999;
+ }
+ while ((b->num_limbs > 1) && (b->limbs[b->num_limbs - 1] == 0))
+ {
+  b->num_limbs--;
+ }
+}
+
+static int
+exhaustive_bignum_print(const exhaustive_bignum *b, char *buf)
+{
+ int n = sprintf(buf, "%u", b->limbs[b->num_limbs - 1]);
+ for (int i = b->num_limbs - 2; i >= 0; i--)
+ {
+  n += sprintf(buf + n, "%09u", b->limbs[i]);
+ }
+ return n;
+}
+
+// exhaustive_check_halfways checks the exact midpoint between the positive
+// finite x and the next double up, which must round to even, and the
+// midpoint plus or minus a tiny amount. It returns the number of checks made.
+static uint64_t
+exhaustive_check_halfways(exhaustive_context *c, double x)
+{
+ uint64_t bits = wuffs_base__ieee_754_bit_representation__from_f64_to_u64(x);
+ uint64_t man = bits & 0x000FFFFFFFFFFFFF;
+ int32_t exp2 = (int32_t)(bits >> 52);
+ if (exp2 == 0)
+ {
+  exp2 = -1074;
+ }
+ else
+ {
+  man |= 0x0010000000000000;
+  exp2 -= 1075;
+ }
+ // The midpoint is ((2 * man) + 1) * (2 ** q).
+ int32_t q = exp2 - 1;
+ exhaustive_bignum b;
+ uint64_t m = (2 * man) + 1;
+ b.limbs[0] = (uint32_t)(m % 1000000000);
+ b.limbs[1] = (uint32_t)((m / 1000000000) % 1000000000);
+ b.limbs[2] = (uint32_t)(m / 1000000000000000000);
+ b.num_limbs = b.limbs[2] ? 3 : b.limbs[1] ? 2 : 1;
+ // For negative q, ((2 ** q) == ((5 ** -q) * (10 ** q))).
+ static const uint32_t pow5[14] = {
+     1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625, 1220703125,
+ };
+ for (int32_t k = (q >= 0) ? q : -q; k > 0; k -= 13)
+ {
+  int32_t j = (k < 13) ? k : 13;
+  exhaustive_bignum_mul(&b, (q >= 0) ? (1u << j) : pow5[j]);
+ }
+ int32_t exp10 = (q >= 0) ? 0 : q;
+
+ double lower = x;
+ double upper = wuffs_base__ieee_754_bit_representation__from_u64_to_f64(bits + 1);
+ char buf[1000];
+ int n = exhaustive_bignum_print(&b, buf);
+ sprintf(buf + n, "e%d", exp10);
+ exhaustive_check_f64(c, "halfway", buf, (man & 1) ? upper : lower);
+ sprintf(buf + n, ".000001e%d", exp10);
+ exhaustive_check_f64(c, "halfway+", buf, upper);
+ exhaustive_bignum_decrement(&b);
+ n = exhaustive_bignum_print(&b, buf);
+ sprintf(buf + n, ".999999e%d", exp10);
+ exhaustive_check_f64(c, "halfway-", buf, lower);
+ return 3;
+}
+
+// exhaustive_f64_chunk checks the doubles around one point: chunk i is
+// either a power of 10 or one of exhaustive_f64_points.
+static void
+exhaustive_f64_chunk(wuffs_private_impl__parallel__job *job, size_t i)
+{
+ exhaustive_context *c = (exhaustive_context *)job->context;
+ uint64_t num_checks = 0;
+ int64_t center;
+ if (i < EXHAUSTIVE_NUM_F64_POINTS)
+ {
+  center = (int64_t)exhaustive_f64_points[i];
+ }
+ else
+ {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "1e%d", EXHAUSTIVE_MIN_POW10 + (int)(i - EXHAUSTIVE_NUM_F64_POINTS));
+  center = (int64_t)wuffs_base__ieee_754_bit_representation__from_f64_to_u64(strtod(buf, NULL));
+ }
+
+ for (int64_t off = -c->width; off <= c->width; off++)
+ {
+  int64_t bits = center + off;
+  if ((bits < 0) || (bits >= 0x7FF0000000000000))
+  {
+   continue;
+  }
+  double x = wuffs_base__ieee_754_bit_representation__from_u64_to_f64((uint64_t)bits);
+  // Alternate the signs.
+  num_checks += exhaustive_check_round_trips(c, (off & 1) ? -x : x, true);
+  if ((-c->halfway_width <= off) && (off <= c->halfway_width))
+  {
+   num_checks += exhaustive_check_halfways(c, x);
+  }
+ }
+ __atomic_fetch_add(&c->num_checks, num_checks, __ATOMIC_RELAXED);
+}
+
+int main(int argc, char **argv)
+{
+ size_t num_threads = 0;
+ exhaustive_context c;
+ memset(&c, 0, sizeof(c));
+ c.f32_stride = 1;
+ c.width = 10000;
+ c.halfway_width = 50;
+ for (int i = 1; i < argc; i++)
+ {
+  long long v = (i + 1 < argc) ? strtoll(argv[i + 1], NULL, 10) : -1;
+  if (!strcmp(argv[i], "-j") && (v > 0))
+  {
+   num_threads = (size_t)v;
+  }
+  else if (!strcmp(argv[i], "-s") && (v > 0))
+  {
+   c.f32_stride = (uint64_t)v;
+  }
+  else if (!strcmp(argv[i], "-w") && (v >= 0))
+  {
+   c.width = v;
+  }
+  else if (!strcmp(argv[i], "-h") && (v >= 0))
+  {
+   c.halfway_width = v;
+  }
+  else
+  {
+   fprintf(stderr, "usage: %s [-j num_threads] [-s f32_stride] [-w ulps] [-h ulps]\n", argv[0]);
+   return 2;
+  }
+  i++;
+ }
+ if (num_threads == 0)
+ {
+  num_threads = wuffs_private_impl__parallel__default_num_threads();
+ }
+ pthread_mutex_init(&c.print_mutex, NULL);
+
+ wuffs_private_impl__parallel__job job;
+ job.context = &c;
+
+ double start = exhaustive_now();
+ job.chunk_fn = &exhaustive_f64_chunk;
+ wuffs_private_impl__parallel__run(&job, EXHAUSTIVE_NUM_F64_POINTS + (EXHAUSTIVE_MAX_POW10 - EXHAUSTIVE_MIN_POW10 + 1), num_threads);
+ printf("doubles: %llu checks in %.1f s\n", (unsigned long long)c.num_checks, exhaustive_now() - start);
+
+ uint64_t num_f64_checks = c.num_checks;
+ start = exhaustive_now();
+ uint64_t span = EXHAUSTIVE_F32_CHUNK_LEN * c.f32_stride;
+ job.chunk_fn = &exhaustive_f32_chunk;
+ wuffs_private_impl__parallel__run(&job, (size_t)((((uint64_t)1 << 32) + span - 1) / span), num_threads);
+ printf("float32s: %llu checks in %.1f s\n", (unsigned long long)(c.num_checks - num_f64_checks), exhaustive_now() - start);
+
+ printf("%llu failures on %zu threads\n", (unsigned long long)c.num_failures, num_threads);
+ return c.num_failures ? 1 : 0;
+}
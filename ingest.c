@@ -0,0 +1,135 @@
+// ingest converts a text file with one number per line into a file of packed
+// little-endian doubles, using wuffs_base__parse_number_f64_lines.
+//
+// Usage: ingest input.txt output.bin
+//
+// The input is memory-mapped and parsed in place. Throughput (MB/s of input
+// and numbers/s) and the number of lines that failed to parse (written as
+// zero) are printed to stderr.
+//
+// Build with: cc -O2 ingest.c -o ingest
+
+// mmap, posix_madvise and clock_gettime are POSIX, not ISO C.
+#define _POSIX_C_SOURCE 200112L
+
+#include "wuffs_eisel_lemire.c"
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define INGEST_CHUNK_LEN 65536
+
+static double
+ingest_now(void)
+{
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+int main(int argc, char **argv)
+{
+ if (argc != 3)
+ {
+  fprintf(stderr, "usage: %s input.txt output.bin\n", argv[0]);
+  return 2;
+ }
+
+ int fd = open(argv[1], O_RDONLY);
+ if (fd < 0)
+ {
+  perror(argv[1]);
+  return 1;
+ }
+ struct stat st;
+ if (fstat(fd, &st) < 0)
+ {
+  perror(argv[1]);
+  close(fd);
+  return 1;
+ }
+ size_t len = (size_t)st.st_size;
+ uint8_t *src = NULL;
+ if (len > 0)
+ {
+  src = (uint8_t *)mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (src == (uint8_t *)MAP_FAILED)
+  {
+   perror("mmap");
+   close(fd);
+   return 1;
+  }
+  posix_madvise(src, len, POSIX_MADV_SEQUENTIAL);
+ }
+
+ FILE *out = fopen(argv[2], "wb");
+ if (!out)
+ {
+  perror(argv[2]);
+  if (src)
+  {
+   munmap(src, len);
+  }
+  close(fd);
+  return 1;
+ }
+
+ static double values[INGEST_CHUNK_LEN];
+ static uint8_t bytes[8 * INGEST_CHUNK_LEN];
+ size_t num_values = 0;
+ size_t num_errors = 0;
+ int ret = 0;
+ double start = ingest_now();
+
+ wuffs_base__slice_u8 remaining = {.ptr = src, .len = len};
+ while (remaining.len > 0)
+ {
+  wuffs_base__parse_number_f64_lines__output o =
+      wuffs_base__parse_number_f64_lines(values, INGEST_CHUNK_LEN, remaining, 0);
+  remaining.ptr += o.num_bytes;
+  remaining.len -= o.num_bytes;
+  num_values += o.num_values;
+  num_errors += o.num_errors;
+
+  // Serialize explicitly, so that the output is little-endian regardless of
+  // the host's byte order.
+  for (size_t i = 0; i < o.num_values; i++)
+  {
+   uint64_t u = wuffs_base__ieee_754_bit_representation__from_f64_to_u64(values[i]);
+   for (int j = 0; j < 8; j++)
+   {
+    bytes[(8 * i) + j] = (uint8_t)(u >> (8 * j));
+   }
+  }
+  if (fwrite(bytes, 8, o.num_values, out) != o.num_values)
+  {
+   perror(argv[2]);
+   ret = 1;
+   break;
+  }
+ }
+
+ if (fclose(out) != 0)
+ {
+  perror(argv[2]);
+  ret = 1;
+ }
+ double elapsed = ingest_now() - start;
+ if (src)
+ {
+  munmap(src, len);
+ }
+ close(fd);
+
+ if (elapsed <= 0)
+ {
+  elapsed = 1e-9;
+ }
+ fprintf(stderr, "%zu numbers (%zu errors) from %zu bytes in %.3f s: %.1f MB/s, %.1f M numbers/s\n",
+         num_values, num_errors, len, elapsed, (double)len / elapsed / 1e6,
+         (double)num_values / elapsed / 1e6);
+ return ret;
+}
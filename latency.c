@@ -0,0 +1,538 @@
+// latency times individual wuffs_base__parse_number_f64 calls and reports
+// their distribution (p50, p99, p99.9 and max) per input class, so that rare
+// but slow inputs show up instead of being averaged away.
+//
+// Usage: latency [-n num_values] [-g max_p999] [input.txt]
+//
+// The input is a text file with one number per line, or (by default)
+// num_values (default 1000000) synthetic numbers: a seeded mix of short
+// decimals, 17-digit output, long mantissas, subnormals and huge exponents.
+//
+// Each call is timed with the x86 time stamp counter (rdtsc), or with
+// clock_gettime elsewhere, minus the timer's own overhead. The results go
+// into log-scale histograms (4 buckets per power of 2) by digit count, by
+// the value's magnitude and by which path the parser took (from the
+// WUFFS_CONFIG__ENABLE_PARSE_NUMBER_STATS counters).
+//
+// As a release gate, -g makes the exit status non-zero if the overall p99.9
+// is above max_p999 ticks.
+//
+// Build with: cc -O2 latency.c -o latency
+
+// clock_gettime (used on non-x86 CPUs) is POSIX, not ISO C.
+#define _POSIX_C_SOURCE 199309L
+
+#define WUFFS_CONFIG__ENABLE_PARSE_NUMBER_STATS
+#include "wuffs_eisel_lemire.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+#include <x86intrin.h>
+#define LATENCY_UNIT "cycles"
+#else
+#define LATENCY_UNIT "ns"
+#endif
+
+// A histogram has 4 buckets per power of 2, up to 2**63 ticks.
+#define LATENCY_NUM_BUCKETS (4 * 64)
+
+typedef struct
+{
+ const char *name;
+ uint64_t count;
+ uint64_t max;
+ uint64_t buckets[LATENCY_NUM_BUCKETS];
+} latency_histogram;
+
+static inline uint64_t
+latency_ticks(void)
+{
+#if defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+ // The fences keep the timed code from being reordered around the reads.
+ _mm_lfence();
+ uint64_t t = __rdtsc();
+ _mm_lfence();
+ return t;
+#else
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return ((uint64_t)ts.tv_sec * 1000000000) + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// latency_bucket maps t to its bucket: 4 * floor(log2(t)) plus the next 2
+// bits below the leading 1 bit. Values below 4 have their own buckets.
+static size_t
+latency_bucket(uint64_t t)
+{
+ if (t < 4)
+ {
+  return (size_t)t;
+ }
+ int lg = 63 - __builtin_clzll(t);
+ return (size_t)((4 * lg) + ((t >> (lg - 2)) & 3));
+}
+
+// latency_bucket_upper returns the largest t in bucket b.
+static uint64_t
+latency_bucket_upper(size_t b)
+{
+ if (b < 4)
+ {
+  return (uint64_t)b;
+ }
+ int lg = (int)(b / 4);
+ uint64_t lo = ((uint64_t)(4 + (b & 3))) << (lg - 2);
+ return lo + (((uint64_t)1) << (lg - 2)) - 1;
+}
+
+static void
+latency_record(latency_histogram *h, uint64_t t)
+{
+ h->count++;
+ h->buckets[latency_bucket(t)]++;
+ if (h->max < t)
+ {
+  h->max = t;
+ }
+}
+
+// latency_percentile returns an upper bound on the p'th percentile.
+static uint64_t
+latency_percentile(const latency_histogram *h, double p)
+{
+ uint64_t rank = (uint64_t)((p / 100.0) * (double)h->count);
+ if (rank >= h->count)
+ {
+  rank = h->count - 1;
+ }
+ uint64_t seen = 0;
+ for (size_t b = 0; b < LATENCY_NUM_BUCKETS; b++)
+ {
+  seen += h->buckets[b];
+  if (seen > rank)
+  {
+   uint64_t u = latency_bucket_upper(b);
+   return (u < h->max) ? u : h->max;
+  }
+ }
+ return h->max;
+}
+
+static void
+latency_print(const latency_histogram *h)
+{
+ if (h->count == 0)
+ {
+  return;
+ }
+ printf("  %-30s %10llu %8llu %8llu %8llu %8llu\n", h->name,
+        (unsigned long long)h->count,
+        (unsigned long long)latency_percentile(h, 50.0),
+        (unsigned long long)latency_percentile(h, 99.0),
+        (unsigned long long)latency_percentile(h, 99.9),
+        (unsigned long long)h->max);
+}
+
+// ---------------- Input Classes
+
+enum
+{
+ LATENCY_DIGITS_1_TO_8,
+ LATENCY_DIGITS_9_TO_15,
+ LATENCY_DIGITS_16_TO_19,
+ LATENCY_DIGITS_20_PLUS,
+ LATENCY_NUM_DIGIT_CLASSES,
+};
+
+static const char *latency_digit_class_names[LATENCY_NUM_DIGIT_CLASSES] = {
+    "1-8 digits", "9-15 digits", "16-19 digits", "20+ digits",
+};
+
+enum
+{
+ LATENCY_MAGNITUDE_ZERO,
+ LATENCY_MAGNITUDE_SUBNORMAL,
+ LATENCY_MAGNITUDE_EXACT_POWERS,
+ LATENCY_MAGNITUDE_OTHER_NORMAL,
+ LATENCY_MAGNITUDE_INFINITE,
+ LATENCY_MAGNITUDE_ERROR,
+ LATENCY_NUM_MAGNITUDE_CLASSES,
+};
+
+static const char *latency_magnitude_class_names[LATENCY_NUM_MAGNITUDE_CLASSES] = {
+    "zero", "subnormal", "1e-22 <= |x| <= 1e22", "other normal", "infinite", "error",
+};
+
+enum
+{
+ LATENCY_PATH_CLINGER,
+ LATENCY_PATH_EISEL_LEMIRE,
+ LATENCY_PATH_FALLBACK_EXTREME,
+ LATENCY_PATH_FALLBACK_EISEL_LEMIRE,
+ LATENCY_PATH_FALLBACK_DIGIT_COMPARISON,
+ LATENCY_PATH_FALLBACK_SIMPLE_DECIMAL_CONVERSION,
+ LATENCY_PATH_SPECIAL,
+ LATENCY_NUM_PATH_CLASSES,
+};
+
+static const char *latency_path_class_names[LATENCY_NUM_PATH_CLASSES] = {
+    "clinger",
+    "eisel_lemire",
+    "fallback_extreme",
+    "fallback_eisel_lemire",
+    "fallback_digit_comparison",
+    "fallback_simple_decimal_conv",
+    "special",
+};
+
+// latency_count_digits counts s's mantissa digits, ignoring leading zeroes.
+static int
+latency_count_digits(wuffs_base__slice_u8 s)
+{
+ int n = 0;
+ for (size_t i = 0; i < s.len; i++)
+ {
+  uint8_t c = s.ptr[i];
+  if ((c == 'e') || (c == 'E'))
+  {
+   break;
+  }
+  else if ((c >= '1') && (c <= '9'))
+  {
+   n++;
+  }
+  else if ((c == '0') && (n > 0))
+  {
+   n++;
+  }
+ }
+ return n;
+}
+
+static int
+latency_digit_class(wuffs_base__slice_u8 s)
+{
+ int n = latency_count_digits(s);
+ return (n <= 8) ? LATENCY_DIGITS_1_TO_8 : (n <= 15) ? LATENCY_DIGITS_9_TO_15 : (n <= 19) ? LATENCY_DIGITS_16_TO_19 : LATENCY_DIGITS_20_PLUS;
+}
+
+static int
+latency_magnitude_class(wuffs_base__result_f64 r)
+{
+ double a = (r.value < 0) ? -r.value : r.value;
+ if (r.status.repr)
+ {
+  return LATENCY_MAGNITUDE_ERROR;
+ }
+ else if (a == 0)
+ {
+  return LATENCY_MAGNITUDE_ZERO;
+ }
+ else if (a < 2.2250738585072014e-308)
+ {
+  return LATENCY_MAGNITUDE_SUBNORMAL;
+ }
+ else if ((a >= 1e-22) && (a <= 1e22))
+ {
+  return LATENCY_MAGNITUDE_EXACT_POWERS;
+ }
+ else if (a <= 1.7976931348623157e308)
+ {
+  return LATENCY_MAGNITUDE_OTHER_NORMAL;
+ }
+ return LATENCY_MAGNITUDE_INFINITE;
+}
+
+// latency_path_class returns which counter went up between before and after,
+// or -1 if none did (such as for NaN, which isn't counted).
+static int
+latency_path_class(const wuffs_base__parse_number__stats *before, const wuffs_base__parse_number__stats *after)
+{
+ if (after->clinger != before->clinger)
+ {
+  return LATENCY_PATH_CLINGER;
+ }
+ else if (after->eisel_lemire != before->eisel_lemire)
+ {
+  return LATENCY_PATH_EISEL_LEMIRE;
+ }
+ else if (after->fallback_extreme != before->fallback_extreme)
+ {
+  return LATENCY_PATH_FALLBACK_EXTREME;
+ }
+ else if (after->fallback_eisel_lemire != before->fallback_eisel_lemire)
+ {
+  return LATENCY_PATH_FALLBACK_EISEL_LEMIRE;
+ }
+ else if (after->fallback_digit_comparison != before->fallback_digit_comparison)
+ {
+  return LATENCY_PATH_FALLBACK_DIGIT_COMPARISON;
+ }
+ else if (after->fallback_simple_decimal_conversion != before->fallback_simple_decimal_conversion)
+ {
+  return LATENCY_PATH_FALLBACK_SIMPLE_DECIMAL_CONVERSION;
+ }
+ else if (after->special != before->special)
+ {
+  return LATENCY_PATH_SPECIAL;
+ }
+ return -1;
+}
+
+// ---------------- Inputs
+
+static uint64_t latency_rng_state = 0x9E3779B97F4A7C15;
+
+static uint64_t
+latency_rng(void)
+{
+ // xorshift64*
+ latency_rng_state ^= latency_rng_state >> 12;
+ latency_rng_state ^= latency_rng_state << 25;
+ latency_rng_state ^= latency_rng_state >> 27;
+ return latency_rng_state * 0x2545F4914F6CDD1D;
+}
+
+static int
+latency_generate_one(char *buf, size_t buf_len)
+{
+ uint64_t kind = latency_rng() % 100;
+ double x;
+ if (kind < 40)
+ {
+  // Short decimals, such as prices or sensor readings.
+  return snprintf(buf, buf_len, "%d.%02d", (int)(latency_rng() % 100000), (int)(latency_rng() % 100));
+ }
+ else if (kind < 80)
+ {
+  // 17-digit output of random finite bit patterns.
+  do
+  {
+   x = wuffs_base__ieee_754_bit_representation__from_u64_to_f64(latency_rng());
+  } while ((x != x) || ((x - x) != 0));
+  return snprintf(buf, buf_len, "%.17g", x);
+ }
+ else if (kind < 90)
+ {
+  // Long mantissas.
+  int n = 20 + (int)(latency_rng() % 60);
+  int len = 0;
+  buf[len++] = (char)('1' + (latency_rng() % 9));
+  buf[len++] = '.';
+  for (int j = 1; j < n; j++)
+  {
+   buf[len++] = (char)('0' + (latency_rng() % 10));
+  }
+  return len + snprintf(buf + len, buf_len - len, "e%d", (int)(latency_rng() % 640) - 320);
+ }
+ else if (kind < 97)
+ {
+  // Subnormals.
+  x = wuffs_base__ieee_754_bit_representation__from_u64_to_f64(latency_rng() & 0x000FFFFFFFFFFFFF);
+  return snprintf(buf, buf_len, "%.17g", x);
+ }
+ // Huge or tiny exponents.
+ return snprintf(buf, buf_len, "%de%d", (int)(latency_rng() % 1000), (int)(latency_rng() % 2000) - 1000);
+}
+
+int main(int argc, char **argv)
+{
+ size_t num_values = 1000000;
+ long long max_p999 = -1;
+ const char *filename = NULL;
+ for (int i = 1; i < argc; i++)
+ {
+  if (!strcmp(argv[i], "-n") && (i + 1 < argc))
+  {
+   num_values = strtoul(argv[++i], NULL, 10);
+  }
+  else if (!strcmp(argv[i], "-g") && (i + 1 < argc))
+  {
+   max_p999 = strtoll(argv[++i], NULL, 10);
+  }
+  else if ((argv[i][0] != '-') && !filename)
+  {
+   filename = argv[i];
+  }
+  else
+  {
+   fprintf(stderr, "usage: %s [-n num_values] [-g max_p999] [input.txt]\n", argv[0]);
+   return 2;
+  }
+ }
+
+ // Gather the inputs into one buffer of newline-terminated numbers.
+ char *text = NULL;
+ size_t text_len = 0;
+ if (filename)
+ {
+  FILE *f = fopen(filename, "rb");
+  if (!f)
+  {
+   perror(filename);
+   return 1;
+  }
+  size_t cap = 0;
+  while (true)
+  {
+   if (text_len == cap)
+   {
+    cap = cap ? (2 * cap) : 65536;
+    text = (char *)realloc(text, cap + 1);
+    if (!text)
+    {
+     fprintf(stderr, "out of memory\n");
+     return 1;
+    }
+   }
+   size_t n = fread(text + text_len, 1, cap - text_len, f);
+   if (n == 0)
+   {
+    break;
+   }
+   text_len += n;
+  }
+  fclose(f);
+  text[text_len++] = '\n';
+ }
+ else
+ {
+  text = (char *)malloc(num_values * 128);
+  if (!text)
+  {
+   fprintf(stderr, "out of memory\n");
+   return 1;
+  }
+  for (size_t i = 0; i < num_values; i++)
+  {
+   text_len += (size_t)latency_generate_one(text + text_len, 127);
+   text[text_len++] = '\n';
+  }
+ }
+
+ // Split it into lines, dropping any "\r" and empty lines.
+ wuffs_base__slice_u8 *inputs = (wuffs_base__slice_u8 *)malloc((text_len + 1) * sizeof(wuffs_base__slice_u8));
+ if (!inputs)
+ {
+  fprintf(stderr, "out of memory\n");
+  return 1;
+ }
+ size_t num_inputs = 0;
+ for (size_t i = 0, start = 0; i < text_len; i++)
+ {
+  if (text[i] == '\n')
+  {
+   size_t end = ((i > start) && (text[i - 1] == '\r')) ? (i - 1) : i;
+   if (end > start)
+   {
+    inputs[num_inputs].ptr = (uint8_t *)(text + start);
+    inputs[num_inputs].len = end - start;
+    num_inputs++;
+   }
+   start = i + 1;
+  }
+ }
+ if (num_inputs == 0)
+ {
+  fprintf(stderr, "no inputs\n");
+  return 1;
+ }
+
+ // Estimate the timer's own overhead as the fastest of many empty
+ // measurements.
+ uint64_t overhead = UINT64_MAX;
+ for (int i = 0; i < 10000; i++)
+ {
+  uint64_t t0 = latency_ticks();
+  uint64_t t1 = latency_ticks();
+  if (overhead > (t1 - t0))
+  {
+   overhead = t1 - t0;
+  }
+ }
+
+ static latency_histogram all;
+ static latency_histogram by_digits[LATENCY_NUM_DIGIT_CLASSES];
+ static latency_histogram by_magnitude[LATENCY_NUM_MAGNITUDE_CLASSES];
+ static latency_histogram by_path[LATENCY_NUM_PATH_CLASSES];
+ all.name = "all";
+ for (int c = 0; c < LATENCY_NUM_DIGIT_CLASSES; c++)
+ {
+  by_digits[c].name = latency_digit_class_names[c];
+ }
+ for (int c = 0; c < LATENCY_NUM_MAGNITUDE_CLASSES; c++)
+ {
+  by_magnitude[c].name = latency_magnitude_class_names[c];
+ }
+ for (int c = 0; c < LATENCY_NUM_PATH_CLASSES; c++)
+ {
+  by_path[c].name = latency_path_class_names[c];
+ }
+
+ // The first pass warms the caches and branch predictors. The second is
+ // recorded.
+ volatile double sink = 0;
+ for (int pass = 0; pass < 2; pass++)
+ {
+  for (size_t i = 0; i < num_inputs; i++)
+  {
+   wuffs_base__parse_number__stats before = wuffs_base__parse_number__stats__snapshot();
+   uint64_t t0 = latency_ticks();
+   wuffs_base__result_f64 r = wuffs_base__parse_number_f64(inputs[i], 0);
+   uint64_t t1 = latency_ticks();
+   sink = r.value;
+   if (pass == 0)
+   {
+    continue;
+   }
+   wuffs_base__parse_number__stats after = wuffs_base__parse_number__stats__snapshot();
+   uint64_t t = t1 - t0;
+   t = (t > overhead) ? (t - overhead) : 0;
+
+   latency_record(&all, t);
+   latency_record(&by_digits[latency_digit_class(inputs[i])], t);
+   latency_record(&by_magnitude[latency_magnitude_class(r)], t);
+   int path = latency_path_class(&before, &after);
+   if (path >= 0)
+   {
+    latency_record(&by_path[path], t);
+   }
+  }
+ }
+ (void)sink;
+
+ printf("%zu inputs, in %s (timer overhead of %llu subtracted)\n", num_inputs, LATENCY_UNIT, (unsigned long long)overhead);
+ printf("  %-30s %10s %8s %8s %8s %8s\n", "class", "count", "p50", "p99", "p99.9", "max");
+ latency_print(&all);
+ printf("by digit count:\n");
+ for (int c = 0; c < LATENCY_NUM_DIGIT_CLASSES; c++)
+ {
+  latency_print(&by_digits[c]);
+ }
+ printf("by magnitude:\n");
+ for (int c = 0; c < LATENCY_NUM_MAGNITUDE_CLASSES; c++)
+ {
+  latency_print(&by_magnitude[c]);
+ }
+ printf("by path:\n");
+ for (int c = 0; c < LATENCY_NUM_PATH_CLASSES; c++)
+ {
+  latency_print(&by_path[c]);
+ }
+
+ int ret = 0;
+ if (max_p999 >= 0)
+ {
+  uint64_t p999 = latency_percentile(&all, 99.9);
+  if (p999 > (uint64_t)max_p999)
+  {
+   printf("FAIL: p99.9 of %llu is above %lld\n", (unsigned long long)p999, max_p999);
+   ret = 1;
+  }
+ }
+ free(inputs);
+ free(text);
+ return ret;
+}
@@ -32,6 +32,11 @@ wuffs_base__status__is_ok(const wuffs_base__status* z) {
   return z->repr == NULL;
 }
 
+static inline bool  //
+wuffs_base__status__is_note(const wuffs_base__status* z) {
+  return z->repr && (*z->repr != '$') && (*z->repr != '#');
+}
+
 // --------
 
 // WUFFS_BASE__RESULT is a result type: either a status (an error) or a value.
@@ -42,6 +47,7 @@ wuffs_base__status__is_ok(const wuffs_base__status* z) {
     wuffs_base__status status; \
     T value;                   \
   }
+typedef WUFFS_BASE__RESULT(float) wuffs_base__result_f32;
 typedef WUFFS_BASE__RESULT(double) wuffs_base__result_f64;
 
 // --------
@@ -90,6 +96,11 @@ wuffs_base__count_leading_zeroes_u64(uint64_t u) {
   return u ? ((uint32_t)(__builtin_clzl(u))) : 64u;
 }
 
+static inline uint32_t  //
+wuffs_base__count_trailing_zeroes_u64(uint64_t u) {
+  return u ? ((uint32_t)(__builtin_ctzl(u))) : 64u;
+}
+
 #else
 // TODO: consider using the _BitScanReverse intrinsic if defined(_MSC_VER).
 
@@ -127,8 +138,149 @@ wuffs_base__count_leading_zeroes_u64(uint64_t u) {
   return n;
 }
 
+static inline uint32_t  //
+wuffs_base__count_trailing_zeroes_u64(uint64_t u) {
+  if (u == 0) {
+    return 64;
+  }
+
+  uint32_t n = 0;
+  for (; (u & 0xFF) == 0; u >>= 8) {
+    n += 8;
+  }
+  for (; (u & 1) == 0; u >>= 1) {
+    n++;
+  }
+  return n;
+}
+
 #endif  // (defined(__GNUC__) || defined(__clang__)) && (__SIZEOF_LONG__ == 8)
 
+// ---------------- Memory Might Be Unaligned
+
+static inline uint32_t  //
+wuffs_base__peek_u32le__no_bounds_check(const uint8_t* p) {
+  return ((uint32_t)(p[0]) << 0) | ((uint32_t)(p[1]) << 8) |
+         ((uint32_t)(p[2]) << 16) | ((uint32_t)(p[3]) << 24);
+}
+
+static inline uint64_t  //
+wuffs_base__peek_u64le__no_bounds_check(const uint8_t* p) {
+  return ((uint64_t)(p[0]) << 0) | ((uint64_t)(p[1]) << 8) |
+         ((uint64_t)(p[2]) << 16) | ((uint64_t)(p[3]) << 24) |
+         ((uint64_t)(p[4]) << 32) | ((uint64_t)(p[5]) << 40) |
+         ((uint64_t)(p[6]) << 48) | ((uint64_t)(p[7]) << 56);
+}
+
+// ---------------- Compiler Hints
+
+// WUFFS_BASE__FORCE_INLINE marks a function that should be inlined even when
+// the compiler's heuristics say otherwise (for example, when it is large or
+// has many callers). Inlining a call with a constant options argument lets
+// the compiler fold away every branch on those options.
+#if defined(__GNUC__) || defined(__clang__)
+#define WUFFS_BASE__FORCE_INLINE __attribute__((always_inline)) inline
+#elif defined(_MSC_VER)
+#define WUFFS_BASE__FORCE_INLINE __forceinline
+#else
+#define WUFFS_BASE__FORCE_INLINE inline
+#endif
+
+// WUFFS_BASE__POTENTIALLY_UNUSED marks a public (but static, since this file
+// is #include'd, not linked) function that a program might not call, so that
+// -Wunused-function stays quiet about it.
+#if defined(__GNUC__) || defined(__clang__)
+#define WUFFS_BASE__POTENTIALLY_UNUSED __attribute__((unused))
+#else
+#define WUFFS_BASE__POTENTIALLY_UNUSED
+#endif
+
+// ---------------- CPU Architecture
+
+// WUFFS_BASE__CPU_ARCH__X86_FAMILY is defined when the SIMD (x86 SSE4.1 and
+// AVX2) code paths are compiled in. Those paths are chosen at run time, based
+// on what the CPU supports, so that the one binary still runs on CPUs that
+// don't support them. Define WUFFS_CONFIG__AVOID_CPU_ARCH to compile them out,
+// leaving only the portable code paths.
+#if !defined(WUFFS_CONFIG__AVOID_CPU_ARCH) && \
+    (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define WUFFS_BASE__CPU_ARCH__X86_FAMILY
+#include <cpuid.h>
+#include <immintrin.h>
+#define WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(arg) __attribute__((target(arg)))
+#else
+#define WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(arg)
+#endif
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+
+#define WUFFS_PRIVATE_IMPL__CPU_ARCH__X86_SSE41 0x01u
+#define WUFFS_PRIVATE_IMPL__CPU_ARCH__X86_AVX2 0x02u
+#define WUFFS_PRIVATE_IMPL__CPU_ARCH__X86_DETECTED 0x80000000u
+
+// wuffs_private_impl__cpu_arch__x86_detect returns the
+// WUFFS_PRIVATE_IMPL__CPU_ARCH__X86_ETC bits for what the CPU (and, for AVX2,
+// the OS) supports.
+static inline uint32_t  //
+wuffs_private_impl__cpu_arch__x86_detect(void) {
+  uint32_t flags = WUFFS_PRIVATE_IMPL__CPU_ARCH__X86_DETECTED;
+  unsigned int eax = 0;
+  unsigned int ebx = 0;
+  unsigned int ecx = 0;
+  unsigned int edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return flags;
+  }
+  if (ecx & bit_SSE4_1) {
+    flags |= WUFFS_PRIVATE_IMPL__CPU_ARCH__X86_SSE41;
+  }
+
+  // Using the 256-bit YMM registers also needs the OS to save and restore
+  // them on context switches: bits 1 (SSE) and 2 (AVX) of XCR0.
+  if (!(ecx & bit_OSXSAVE)) {
+    return flags;
+  }
+  uint32_t xcr0_lo = 0;
+  uint32_t xcr0_hi = 0;
+  __asm__ __volatile__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  if ((xcr0_lo & 6) != 6) {
+    return flags;
+  }
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_AVX2)) {
+    flags |= WUFFS_PRIVATE_IMPL__CPU_ARCH__X86_AVX2;
+  }
+  return flags;
+}
+
+// wuffs_private_impl__cpu_arch__x86_flags is like
+// wuffs_private_impl__cpu_arch__x86_detect but it caches the answer, as the
+// CPUID instruction is slow (relative to parsing a number). Racing threads
+// might each detect the flags but they'll all store the same value.
+static inline uint32_t  //
+wuffs_private_impl__cpu_arch__x86_flags(void) {
+  static uint32_t cached_flags = 0;
+  uint32_t flags = __atomic_load_n(&cached_flags, __ATOMIC_RELAXED);
+  if (!flags) {
+    flags = wuffs_private_impl__cpu_arch__x86_detect();
+    __atomic_store_n(&cached_flags, flags, __ATOMIC_RELAXED);
+  }
+  return flags;
+}
+
+static inline bool  //
+wuffs_base__cpu_arch__have_x86_sse41(void) {
+  return wuffs_private_impl__cpu_arch__x86_flags() &
+         WUFFS_PRIVATE_IMPL__CPU_ARCH__X86_SSE41;
+}
+
+static inline bool  //
+wuffs_base__cpu_arch__have_x86_avx2(void) {
+  return wuffs_private_impl__cpu_arch__x86_flags() &
+         WUFFS_PRIVATE_IMPL__CPU_ARCH__X86_AVX2;
+}
+
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+
 // ---------------- Slices and Tables
 
 // WUFFS_BASE__SLICE is a 1-dimensional buffer.
@@ -177,6 +329,59 @@ typedef WUFFS_BASE__SLICE(uint8_t) wuffs_base__slice_u8;
 // "1e999" that would overflow double-precision floating point.
 #define WUFFS_BASE__PARSE_NUMBER_FXX__REJECT_INF_AND_NAN ((uint32_t)0x00000020)
 
+// WUFFS_BASE__PARSE_NUMBER_FXX__NUM_PADDING_BYTES is how many bytes after the
+// end of the input slice must be readable (but may hold arbitrary values) when
+// calling the wuffs_base__parse_number_fxx_padded functions. It is 8 so that a
+// whole uint64_t can be loaded starting at any position up to and including
+// the end of the slice.
+#define WUFFS_BASE__PARSE_NUMBER_FXX__NUM_PADDING_BYTES 8
+
+// --------
+
+// Options (bitwise or'ed together) for wuffs_base__render_number_xxx
+// functions. The XXX options apply to both integer and floating point. The FXX
+// options apply only to floating point.
+
+#define WUFFS_BASE__RENDER_NUMBER_XXX__DEFAULT_OPTIONS ((uint32_t)0x00000000)
+
+// WUFFS_BASE__RENDER_NUMBER_XXX__ALIGN_RIGHT means to render to the right side
+// (higher indexes) of the destination slice, leaving any untouched bytes on
+// the left side (lower indexes). The default is vice versa: rendering on the
+// left with slack on the right.
+#define WUFFS_BASE__RENDER_NUMBER_XXX__ALIGN_RIGHT ((uint32_t)0x00000100)
+
+// WUFFS_BASE__RENDER_NUMBER_XXX__LEADING_PLUS_SIGN means to render the leading
+// "+" for non-negative numbers: "+0" and "+12.3" instead of "0" and "12.3".
+#define WUFFS_BASE__RENDER_NUMBER_XXX__LEADING_PLUS_SIGN ((uint32_t)0x00000200)
+
+// WUFFS_BASE__RENDER_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA means to render
+// one-and-a-half as "1,5" instead of "1.5".
+#define WUFFS_BASE__RENDER_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA \
+  ((uint32_t)0x00000400)
+
+// WUFFS_BASE__RENDER_NUMBER_FXX__EXPONENT_ETC means whether to never
+// (EXPONENT_ABSENT, equivalent to printf's "%f") or to always
+// (EXPONENT_PRESENT, equivalent to printf's "%e") render an "e±05"-like
+// exponent suffix. Having neither or both set means a "%g"-like choice.
+#define WUFFS_BASE__RENDER_NUMBER_FXX__EXPONENT_ABSENT ((uint32_t)0x00000800)
+#define WUFFS_BASE__RENDER_NUMBER_FXX__EXPONENT_PRESENT ((uint32_t)0x00001000)
+
+// WUFFS_BASE__RENDER_NUMBER_FXX__JUST_ENOUGH_PRECISION means to render the
+// smallest number of digits so that parsing the resultant string will recover
+// the same double-precision floating point number. It ignores the precision
+// argument.
+#define WUFFS_BASE__RENDER_NUMBER_FXX__JUST_ENOUGH_PRECISION \
+  ((uint32_t)0x00002000)
+
+static inline uint64_t  //
+wuffs_base__ieee_754_bit_representation__from_f64_to_u64(double f) {
+  uint64_t u = 0;
+  if (sizeof(uint64_t) == sizeof(double)) {
+    memcpy(&u, &f, sizeof(uint64_t));
+  }
+  return u;
+}
+
 static inline double  //
 wuffs_base__ieee_754_bit_representation__from_u16_to_f64(uint16_t u) {
   uint64_t v = ((uint64_t)(u & 0x8000)) << 48;
@@ -214,6 +419,15 @@ wuffs_base__ieee_754_bit_representation__from_u32_to_f64(uint32_t u) {
   return (double)f;
 }
 
+static inline float  //
+wuffs_base__ieee_754_bit_representation__from_u32_to_f32(uint32_t u) {
+  float f = 0;
+  if (sizeof(uint32_t) == sizeof(float)) {
+    memcpy(&f, &u, sizeof(uint32_t));
+  }
+  return f;
+}
+
 static inline double  //
 wuffs_base__ieee_754_bit_representation__from_u64_to_f64(uint64_t u) {
   double f = 0;
@@ -226,8 +440,121 @@ wuffs_base__ieee_754_bit_representation__from_u64_to_f64(uint64_t u) {
 // ---------------- String Conversions
 
 const char wuffs_base__error__bad_argument[] = "#base: bad argument";
+const char wuffs_base__error__bad_argument_length_too_short[] =
+    "#base: bad argument (length too short)";
 const char wuffs_base__error__bad_receiver[] = "#base: bad receiver";
 
+const char wuffs_base__note__null_value[] = "@base: null value";
+
+// ---------------- Parse Number Statistics
+
+// wuffs_base__parse_number__stats counts how f64 parsing ended: which exit of
+// the fast path or of the fallback produced each value. Comparing the counts
+// shows whether a workload's latency tail comes from the slower exits.
+//
+// The counters are only updated if WUFFS_CONFIG__ENABLE_PARSE_NUMBER_STATS is
+// defined. By default, they compile out entirely (the parser has no extra
+// instructions) and a snapshot is all zeroes.
+//
+// Each thread has its own counters, so that counting needs no atomic
+// operations and doesn't bounce cache lines between threads. Take a snapshot
+// on each thread of interest and merge them.
+typedef struct wuffs_base__parse_number__stats__struct {
+  // clinger counts the values that the fast path's Clinger shortcut (an
+  // exact mantissa times an exact power of 10) produced.
+  uint64_t clinger;
+  // eisel_lemire counts the values that the fast path's Eisel-Lemire
+  // algorithm produced.
+  uint64_t eisel_lemire;
+
+  // The fallback_etc fields count the values that
+  // wuffs_private_impl__high_prec_dec__to_f64 produced. fallback_extreme is
+  // the obvious zeroes and infinities, fallback_eisel_lemire is the retry of
+  // Eisel-Lemire using the high_prec_dec's digits, fallback_digit_comparison
+  // is the big integer comparison and fallback_simple_decimal_conversion is
+  // the last resort.
+  uint64_t fallback_extreme;
+  uint64_t fallback_eisel_lemire;
+  uint64_t fallback_digit_comparison;
+  uint64_t fallback_simple_decimal_conversion;
+
+  // special counts the inputs that weren't a decimal number: "inf", "nan"
+  // (and their variants) and invalid inputs.
+  uint64_t special;
+
+  // last_slow_input holds the first bytes (up to sizeof(last_slow_input)) of
+  // the most recent text input that needed Simple Decimal Conversion, and
+  // last_slow_input_len is its full length. A merge keeps the destination's
+  // sample unless it has none.
+  uint8_t last_slow_input[32];
+  size_t last_slow_input_len;
+} wuffs_base__parse_number__stats;
+
+#if defined(WUFFS_CONFIG__ENABLE_PARSE_NUMBER_STATS)
+
+#if defined(__cplusplus)
+#define WUFFS_PRIVATE_IMPL__THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define WUFFS_PRIVATE_IMPL__THREAD_LOCAL __declspec(thread)
+#else
+#define WUFFS_PRIVATE_IMPL__THREAD_LOCAL _Thread_local
+#endif
+
+static WUFFS_PRIVATE_IMPL__THREAD_LOCAL wuffs_base__parse_number__stats
+    wuffs_private_impl__parse_number__stats;
+
+#define WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(field) \
+  (wuffs_private_impl__parse_number__stats.field++)
+
+#else
+
+#define WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(field) ((void)0)
+
+#endif  // defined(WUFFS_CONFIG__ENABLE_PARSE_NUMBER_STATS)
+
+// wuffs_base__parse_number__stats__snapshot returns a copy of the calling
+// thread's counters.
+static inline wuffs_base__parse_number__stats  //
+wuffs_base__parse_number__stats__snapshot(void) {
+#if defined(WUFFS_CONFIG__ENABLE_PARSE_NUMBER_STATS)
+  return wuffs_private_impl__parse_number__stats;
+#else
+  wuffs_base__parse_number__stats ret;
+  memset(&ret, 0, sizeof(ret));
+  return ret;
+#endif
+}
+
+// wuffs_base__parse_number__stats__reset zeroes the calling thread's
+// counters.
+static inline void  //
+wuffs_base__parse_number__stats__reset(void) {
+#if defined(WUFFS_CONFIG__ENABLE_PARSE_NUMBER_STATS)
+  memset(&wuffs_private_impl__parse_number__stats, 0,
+         sizeof(wuffs_private_impl__parse_number__stats));
+#endif
+}
+
+// wuffs_base__parse_number__stats__merge adds src's counts to dst's.
+static inline void  //
+wuffs_base__parse_number__stats__merge(
+    wuffs_base__parse_number__stats* dst,
+    const wuffs_base__parse_number__stats* src) {
+  dst->clinger += src->clinger;
+  dst->eisel_lemire += src->eisel_lemire;
+  dst->fallback_extreme += src->fallback_extreme;
+  dst->fallback_eisel_lemire += src->fallback_eisel_lemire;
+  dst->fallback_digit_comparison += src->fallback_digit_comparison;
+  dst->fallback_simple_decimal_conversion +=
+      src->fallback_simple_decimal_conversion;
+  dst->special += src->special;
+  if ((dst->last_slow_input_len == 0) && (src->last_slow_input_len > 0)) {
+    memcpy(dst->last_slow_input, src->last_slow_input,
+           sizeof(dst->last_slow_input));
+    dst->last_slow_input_len = src->last_slow_input_len;
+  }
+}
+
 // ---------------- IEEE 754 Floating Point
 
 // The etc__hpd_left_shift and etc__powers_of_5 tables were printed by
@@ -344,9 +671,15 @@ static const uint8_t wuffs_private_impl__powers_of_5[0x051C] = {
 // --------
 
 // wuffs_private_impl__powers_of_10 contains truncated approximations to the
-// powers of 10, ranging from 1e-307 to 1e+288 inclusive, as 596 pairs of
+// powers of 10, ranging from 1e-342 to 1e+324 inclusive, as 667 pairs of
 // uint64_t values (a 128-bit mantissa).
 //
+// Parsing uses the 1e-342 to 1e+308 rows. That range extends far enough that
+// (man * (10 ** exp10)), for any non-zero uint64_t man, is either below half
+// of the smallest positive subnormal f64 or at least the largest finite f64.
+// Rendering uses the 1e-292 to 1e+324 rows, scaling every finite f64 (down to
+// the smallest subnormal, approximately 4.94e-324) to a 17 digit integer.
+//
 // There's also an implicit third column (implied by a linear formula involving
 // the base-10 exponent) that is the base-2 exponent, biased by a magic
 // constant. That constant (1214 or 0x04BE) equals 1023 + 191. 1023 is the bias
@@ -354,7 +687,7 @@ static const uint8_t wuffs_private_impl__powers_of_5[0x051C] = {
 // wuffs_private_impl__parse_number_f64_eisel_lemire works with
 // multiples-of-64-bit mantissas.
 //
-// For example, the third row holds the approximation to 1e-305:
+// For example, the row for 1e-305 holds:
 //   0xE0B62E29_29ABA83C_331ACDAB_FE94DE87 * (2 ** (0x0049 - 0x04BE))
 //
 // Similarly, 1e+4 is approximated by:
@@ -364,7 +697,42 @@ static const uint8_t wuffs_private_impl__powers_of_5[0x051C] = {
 //   0xED63A231_D4C4FB27_4CA7AAA8_63EE4BDD * (2 ** (0x0520 - 0x04BE))
 //
 // This table was generated by by script/print-mpb-powers-of-10.go
-static const uint64_t wuffs_private_impl__powers_of_10[596][2] = {
+static const uint64_t wuffs_private_impl__powers_of_10[667][2] = {
+    {0x113FAA2906A13B3F, 0xEEF453D6923BD65A},  // 1e-342
+    {0x4AC7CA59A424C507, 0x9558B4661B6565F8},  // 1e-341
+    {0x5D79BCF00D2DF649, 0xBAAEE17FA23EBF76},  // 1e-340
+    {0xF4D82C2C107973DC, 0xE95A99DF8ACE6F53},  // 1e-339
+    {0x79071B9B8A4BE869, 0x91D8A02BB6C10594},  // 1e-338
+    {0x9748E2826CDEE284, 0xB64EC836A47146F9},  // 1e-337
+    {0xFD1B1B2308169B25, 0xE3E27A444D8D98B7},  // 1e-336
+    {0xFE30F0F5E50E20F7, 0x8E6D8C6AB0787F72},  // 1e-335
+    {0xBDBD2D335E51A935, 0xB208EF855C969F4F},  // 1e-334
+    {0xAD2C788035E61382, 0xDE8B2B66B3BC4723},  // 1e-333
+    {0x4C3BCB5021AFCC31, 0x8B16FB203055AC76},  // 1e-332
+    {0xDF4ABE242A1BBF3D, 0xADDCB9E83C6B1793},  // 1e-331
+    {0xD71D6DAD34A2AF0D, 0xD953E8624B85DD78},  // 1e-330
+    {0x8672648C40E5AD68, 0x87D4713D6F33AA6B},  // 1e-329
+    {0x680EFDAF511F18C2, 0xA9C98D8CCB009506},  // 1e-328
+    {0x0212BD1B2566DEF2, 0xD43BF0EFFDC0BA48},  // 1e-327
+    {0x014BB630F7604B57, 0x84A57695FE98746D},  // 1e-326
+    {0x419EA3BD35385E2D, 0xA5CED43B7E3E9188},  // 1e-325
+    {0x52064CAC828675B9, 0xCF42894A5DCE35EA},  // 1e-324
+    {0x7343EFEBD1940993, 0x818995CE7AA0E1B2},  // 1e-323
+    {0x1014EBE6C5F90BF8, 0xA1EBFB4219491A1F},  // 1e-322
+    {0xD41A26E077774EF6, 0xCA66FA129F9B60A6},  // 1e-321
+    {0x8920B098955522B4, 0xFD00B897478238D0},  // 1e-320
+    {0x55B46E5F5D5535B0, 0x9E20735E8CB16382},  // 1e-319
+    {0xEB2189F734AA831D, 0xC5A890362FDDBC62},  // 1e-318
+    {0xA5E9EC7501D523E4, 0xF712B443BBD52B7B},  // 1e-317
+    {0x47B233C92125366E, 0x9A6BB0AA55653B2D},  // 1e-316
+    {0x999EC0BB696E840A, 0xC1069CD4EABE89F8},  // 1e-315
+    {0xC00670EA43CA250D, 0xF148440A256E2C76},  // 1e-314
+    {0x380406926A5E5728, 0x96CD2A865764DBCA},  // 1e-313
+    {0xC605083704F5ECF2, 0xBC807527ED3E12BC},  // 1e-312
+    {0xF7864A44C633682E, 0xEBA09271E88D976B},  // 1e-311
+    {0x7AB3EE6AFBE0211D, 0x93445B8731587EA3},  // 1e-310
+    {0x5960EA05BAD82964, 0xB8157268FDAE9E4C},  // 1e-309
+    {0x6FB92487298E33BD, 0xE61ACF033D1A45DF},  // 1e-308
     {0xA5D3B6D479F8E056, 0x8FD0C16206306BAB},  // 1e-307
     {0x8F48A4899877186C, 0xB3C4F1BA87BC8696},  // 1e-306
     {0x331ACDABFE94DE87, 0xE0B62E2929ABA83C},  // 1e-305
@@ -961,6 +1329,42 @@ static const uint64_t wuffs_private_impl__powers_of_10[596][2] = {
     {0x49ED8EABCCCC485D, 0x867F59A9D4BED6C0},  // 1e286
     {0x5C68F256BFFF5A74, 0xA81F301449EE8C70},  // 1e287
     {0x73832EEC6FFF3111, 0xD226FC195C6A2F8C},  // 1e288
+    {0xC831FD53C5FF7EAB, 0x83585D8FD9C25DB7},  // 1e289
+    {0xBA3E7CA8B77F5E55, 0xA42E74F3D032F525},  // 1e290
+    {0x28CE1BD2E55F35EB, 0xCD3A1230C43FB26F},  // 1e291
+    {0x7980D163CF5B81B3, 0x80444B5E7AA7CF85},  // 1e292
+    {0xD7E105BCC332621F, 0xA0555E361951C366},  // 1e293
+    {0x8DD9472BF3FEFAA7, 0xC86AB5C39FA63440},  // 1e294
+    {0xB14F98F6F0FEB951, 0xFA856334878FC150},  // 1e295
+    {0x6ED1BF9A569F33D3, 0x9C935E00D4B9D8D2},  // 1e296
+    {0x0A862F80EC4700C8, 0xC3B8358109E84F07},  // 1e297
+    {0xCD27BB612758C0FA, 0xF4A642E14C6262C8},  // 1e298
+    {0x8038D51CB897789C, 0x98E7E9CCCFBD7DBD},  // 1e299
+    {0xE0470A63E6BD56C3, 0xBF21E44003ACDD2C},  // 1e300
+    {0x1858CCFCE06CAC74, 0xEEEA5D5004981478},  // 1e301
+    {0x0F37801E0C43EBC8, 0x95527A5202DF0CCB},  // 1e302
+    {0xD30560258F54E6BA, 0xBAA718E68396CFFD},  // 1e303
+    {0x47C6B82EF32A2069, 0xE950DF20247C83FD},  // 1e304
+    {0x4CDC331D57FA5441, 0x91D28B7416CDD27E},  // 1e305
+    {0xE0133FE4ADF8E952, 0xB6472E511C81471D},  // 1e306
+    {0x58180FDDD97723A6, 0xE3D8F9E563A198E5},  // 1e307
+    {0x570F09EAA7EA7648, 0x8E679C2F5E44FF8F},  // 1e308
+    {0x2CD2CC6551E513DA, 0xB201833B35D63F73},  // 1e309
+    {0xF8077F7EA65E58D1, 0xDE81E40A034BCF4F},  // 1e310
+    {0xFB04AFAF27FAF782, 0x8B112E86420F6191},  // 1e311
+    {0x79C5DB9AF1F9B563, 0xADD57A27D29339F6},  // 1e312
+    {0x18375281AE7822BC, 0xD94AD8B1C7380874},  // 1e313
+    {0x8F2293910D0B15B5, 0x87CEC76F1C830548},  // 1e314
+    {0xB2EB3875504DDB22, 0xA9C2794AE3A3C69A},  // 1e315
+    {0x5FA60692A46151EB, 0xD433179D9C8CB841},  // 1e316
+    {0xDBC7C41BA6BCD333, 0x849FEEC281D7F328},  // 1e317
+    {0x12B9B522906C0800, 0xA5C7EA73224DEFF3},  // 1e318
+    {0xD768226B34870A00, 0xCF39E50FEAE16BEF},  // 1e319
+    {0xE6A1158300D46640, 0x81842F29F2CCE375},  // 1e320
+    {0x60495AE3C1097FD0, 0xA1E53AF46F801C53},  // 1e321
+    {0x385BB19CB14BDFC4, 0xCA5E89B18B602368},  // 1e322
+    {0x46729E03DD9ED7B5, 0xFCF62C1DEE382C42},  // 1e323
+    {0x6C07A2C26A8346D1, 0x9E19DB92B4E31BA9},  // 1e324
 };
 
 // wuffs_private_impl__f64_powers_of_10 holds powers of 10 that can be exactly
@@ -970,6 +1374,12 @@ static const double wuffs_private_impl__f64_powers_of_10[23] = {
     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
 };
 
+// wuffs_private_impl__f32_powers_of_10 holds powers of 10 that can be exactly
+// represented by a float32 (what C calls a float).
+static const float wuffs_private_impl__f32_powers_of_10[11] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+
 // ---------------- IEEE 754 Floating Point
 
 #define WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE 2047
@@ -1071,7 +1481,9 @@ wuffs_private_impl__high_prec_dec__parse(wuffs_private_impl__high_prec_dec* h,
 
   // Parse sign.
   do {
-    if (*p == '+') {
+    if (p >= q) {
+      return wuffs_base__make_status(wuffs_base__error__bad_argument);
+    } else if (*p == '+') {
       p++;
     } else if (*p == '-') {
       h->negative = true;
@@ -1087,6 +1499,8 @@ wuffs_private_impl__high_prec_dec__parse(wuffs_private_impl__high_prec_dec* h,
           break;
         }
       }
+    } else if (p >= q) {
+      return wuffs_base__make_status(wuffs_base__error__bad_argument);
     }
   } while (0);
 
@@ -1136,7 +1550,12 @@ wuffs_private_impl__high_prec_dec__parse(wuffs_private_impl__high_prec_dec* h,
       if (p >= q) {
         goto after_all;
       } else if (('0' <= *p) && (*p <= '9')) {
-        if (nd < WUFFS_PRIVATE_IMPL__HPD__DIGITS_PRECISION) {
+        if ((nd == 0) && ('0' == *p)) {
+          // Skip leading zeroes that the loop above didn't, such as the
+          // second '0' in "0_0.5" with the ALLOW_UNDERSCORES and
+          // ALLOW_MULTIPLE_LEADING_ZEROES options. digits[0] must be
+          // non-zero.
+        } else if (nd < WUFFS_PRIVATE_IMPL__HPD__DIGITS_PRECISION) {
           h->digits[nd++] = (uint8_t)(*p - '0');
           dp = (int32_t)nd;
         } else if ('0' != *p) {
@@ -1210,7 +1629,9 @@ after_exp:
     }
 
     int32_t exp_sign = +1;
-    if (*p == '+') {
+    if (p >= q) {
+      return wuffs_base__make_status(wuffs_base__error__bad_argument);
+    } else if (*p == '+') {
       p++;
     } else if (*p == '-') {
       exp_sign = -1;
@@ -1479,6 +1900,134 @@ wuffs_private_impl__high_prec_dec__small_rshift(
   wuffs_private_impl__high_prec_dec__trim(h);
 }
 
+// wuffs_private_impl__high_prec_dec__assign sets h to represent the number x.
+//
+// Preconditions:
+//  - h is non-NULL.
+static void  //
+wuffs_private_impl__high_prec_dec__assign(wuffs_private_impl__high_prec_dec* h,
+                                          uint64_t x,
+                                          bool negative) {
+  uint32_t n = 0;
+
+  // Set h->digits.
+  if (x > 0) {
+    // Calculate the digits, working right-to-left. After we determine n (how
+    // many digits there are), copy from buf to h->digits.
+    //
+    // UINT64_MAX, 18446744073709551615, is 20 digits long. It can be faster
+    // to copy a constant number of bytes than a variable number (20 instead
+    // of n). Make buf large enough (and start writing to it from the middle)
+    // so that can we always copy 20 bytes: the slice buf[(20-n) .. (40-n)].
+    uint8_t buf[40] = {0};
+    uint8_t* ptr = &buf[20];
+    do {
+      uint64_t remaining = x / 10;
+      x -= remaining * 10;
+      ptr--;
+      *ptr = (uint8_t)x;
+      n++;
+      x = remaining;
+    } while (x > 0);
+    memcpy(h->digits, ptr, 20);
+  }
+
+  // Set h's other fields.
+  h->num_digits = n;
+  h->decimal_point = (int32_t)n;
+  h->negative = negative;
+  h->truncated = false;
+  wuffs_private_impl__high_prec_dec__trim(h);
+}
+
+// wuffs_private_impl__high_prec_dec__lshift multiplies h by (2 ** shift),
+// where a negative shift means division.
+static void  //
+wuffs_private_impl__high_prec_dec__lshift(wuffs_private_impl__high_prec_dec* h,
+                                          int32_t shift) {
+  if (shift > 0) {
+    while (shift > +WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL) {
+      wuffs_private_impl__high_prec_dec__small_lshift(
+          h, WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL);
+      shift -= WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL;
+    }
+    wuffs_private_impl__high_prec_dec__small_lshift(h, ((uint32_t)(+shift)));
+  } else if (shift < 0) {
+    while (shift < -WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL) {
+      wuffs_private_impl__high_prec_dec__small_rshift(
+          h, WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL);
+      shift += WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL;
+    }
+    wuffs_private_impl__high_prec_dec__small_rshift(h, ((uint32_t)(-shift)));
+  }
+}
+
+// --------
+
+// wuffs_private_impl__high_prec_dec__round_etc rounds h's number. For those
+// functions that take an n argument, rounding produces at most n digits (which
+// is not the same as n decimal places). The "_etc" part means one of:
+//  - "_down" means to round towards zero.
+//  - "_up" means to round away from zero.
+//  - "_nearest" means to round to the nearest value, with ties to even.
+//
+// Preconditions:
+//  - h is non-NULL.
+//  - h->decimal_point is "not extreme".
+
+static void  //
+wuffs_private_impl__high_prec_dec__round_down(
+    wuffs_private_impl__high_prec_dec* h,
+    int32_t n) {
+  if ((n < 0) || (h->num_digits <= (uint32_t)n)) {
+    return;
+  }
+  h->num_digits = (uint32_t)(n);
+  wuffs_private_impl__high_prec_dec__trim(h);
+}
+
+static void  //
+wuffs_private_impl__high_prec_dec__round_up(
+    wuffs_private_impl__high_prec_dec* h,
+    int32_t n) {
+  if ((n < 0) || (h->num_digits <= (uint32_t)n)) {
+    return;
+  }
+
+  for (n--; n >= 0; n--) {
+    if (h->digits[n] < 9) {
+      h->digits[n]++;
+      h->num_digits = (uint32_t)(n + 1);
+      return;
+    }
+  }
+
+  // The number is all 9s. Change to a single 1 and adjust the decimal point.
+  h->digits[0] = 1;
+  h->num_digits = 1;
+  h->decimal_point++;
+}
+
+static void  //
+wuffs_private_impl__high_prec_dec__round_nearest(
+    wuffs_private_impl__high_prec_dec* h,
+    int32_t n) {
+  if ((n < 0) || (h->num_digits <= (uint32_t)n)) {
+    return;
+  }
+  bool up = h->digits[n] >= 5;
+  if ((h->digits[n] == 5) && ((n + 1) == ((int32_t)(h->num_digits)))) {
+    up = h->truncated ||  //
+         ((n > 0) && ((h->digits[n - 1] & 1) != 0));
+  }
+
+  if (up) {
+    wuffs_private_impl__high_prec_dec__round_up(h, n);
+  } else {
+    wuffs_private_impl__high_prec_dec__round_down(h, n);
+  }
+}
+
 // --------
 
 // wuffs_private_impl__parse_number_f64_eisel_lemire produces the IEEE 754
@@ -1491,7 +2040,9 @@ wuffs_private_impl__high_prec_dec__small_rshift(
 // On success, it returns a non-negative int64_t such that the low 63 bits hold
 // the 11-bit exponent and 52-bit mantissa.
 //
-// On failure, it returns a negative value.
+// On failure, it returns a negative value. This includes when the result
+// would be infinite, leaving that (and the REJECT_INF_AND_NAN option) to the
+// caller's fallback.
 //
 // The algorithm is based on an original idea by Michael Eisel that was refined
 // by Daniel Lemire. See
@@ -1501,20 +2052,20 @@ wuffs_private_impl__high_prec_dec__small_rshift(
 //
 // Preconditions:
 //  - man is non-zero.
-//  - exp10 is in the range [-307 ..= 288], the same range of the
+//  - exp10 is in the range [-342 ..= 308], the parsing range of the
 //    wuffs_private_impl__powers_of_10 array.
 //
 // The exp10 range (and the fact that man is in the range [1 ..= UINT64_MAX],
 // approximately [1 ..= 1.85e+19]) means that (man * (10 ** exp10)) is in the
-// range [1e-307 ..= 1.85e+307]. This is entirely within the range of normal
-// (neither subnormal nor non-finite) f64 values: DBL_MIN and DBL_MAX are
-// approximately 2.23e–308 and 1.80e+308.
+// range [1e-342 ..= 1.85e+327]. DBL_TRUE_MIN, DBL_MIN and DBL_MAX are
+// approximately 4.94e-324, 2.23e–308 and 1.80e+308, so the result can be
+// zero, subnormal, normal or infinite.
 static int64_t  //
 wuffs_private_impl__parse_number_f64_eisel_lemire(uint64_t man, int32_t exp10) {
   // Look up the (possibly truncated) base-2 representation of (10 ** exp10).
   // The look-up table was constructed so that it is already normalized: the
   // table entry's mantissa's MSB (most significant bit) is on.
-  const uint64_t* po10 = &wuffs_private_impl__powers_of_10[exp10 + 307][0];
+  const uint64_t* po10 = &wuffs_private_impl__powers_of_10[exp10 + 342][0];
 
   // Normalize the man argument. The (man != 0) precondition means that a
   // non-zero bit exists.
@@ -1523,7 +2074,8 @@ wuffs_private_impl__parse_number_f64_eisel_lemire(uint64_t man, int32_t exp10) {
 
   // Calculate the return value's base-2 exponent. We might tweak it by ±1
   // later, but its initial value comes from a linear scaling of exp10,
-  // converting from power-of-10 to power-of-2, and adjusting by clz.
+  // converting from power-of-10 to power-of-2, and adjusting by clz. It is
+  // signed, as it is zero or negative for subnormal results.
   //
   // The magic constants are:
   //  - 1087 = 1023 + 64. The 1023 is the f64 exponent bias. The 64 is because
@@ -1535,8 +2087,7 @@ wuffs_private_impl__parse_number_f64_eisel_lemire(uint64_t man, int32_t exp10) {
   // Equality of the linearly-scaled value and the actual power-of-2, over the
   // range of exp10 arguments that this function accepts, is confirmed by
   // script/print-mpb-powers-of-10.go
-  uint64_t ret_exp2 =
-      ((uint64_t)(((217706 * exp10) >> 16) + 1087)) - ((uint64_t)clz);
+  int32_t ret_exp2 = ((217706 * exp10) >> 16) + 1087 - ((int32_t)clz);
 
   // Multiply the two mantissas. Normalization means that both mantissas are at
   // least (1<<63), so the 128-bit product must be at least (1<<126). The high
@@ -1623,7 +2174,34 @@ wuffs_private_impl__parse_number_f64_eisel_lemire(uint64_t man, int32_t exp10) {
   // number.
   uint64_t msb = x_hi >> 63;
   uint64_t ret_mantissa = x_hi >> (msb + 9);
-  ret_exp2 -= 1 ^ msb;
+  ret_exp2 -= (int32_t)(1 ^ msb);
+
+  // A biased exponent of 0 (or less) means a subnormal (or zero) result. When
+  // ret_exp2 is 1, the 54-bit ret_mantissa is rounded to 53 bits (below).
+  // Each lower ret_exp2 value loses one more bit.
+  //
+  // Unlike for normal results, there's no need to check for being exactly
+  // half-way between two representable numbers. A subnormal result means
+  // that exp10 is below -307. (man * (10 ** exp10)) is then only a multiple
+  // of a power of 2 if (5 ** -exp10) divides man, but (5 ** 28) already
+  // exceeds UINT64_MAX.
+  //
+  // For example, parsing "4.9e-324" will take the if-true branch here, since:
+  //  - ret_exp2      = -52
+  //  - ret_mantissa  = 0x003F792D3EC653F3
+  if (ret_exp2 <= 0) {
+    uint32_t shift = (uint32_t)(1 - ret_exp2);
+    if (shift >= 64) {
+      return 0;
+    }
+    ret_mantissa >>= shift;
+    ret_mantissa += ret_mantissa & 1;
+    ret_mantissa >>= 1;
+    // If rounding carried up to bit 52 then the result is the smallest normal
+    // number, whose bits (a biased exponent of 1 and zero explicit mantissa)
+    // are still just ret_mantissa.
+    return ((int64_t)ret_mantissa);
+  }
 
   // IEEE 754 rounds to-nearest with ties rounded to-even. Rounding to-even can
   // be tricky. If we're half-way between two exactly representable numbers
@@ -1661,12 +2239,107 @@ wuffs_private_impl__parse_number_f64_eisel_lemire(uint64_t man, int32_t exp10) {
     ret_exp2++;
   }
 
+  // The biased exponent 0x7FF means infinite (or NaN).
+  if (ret_exp2 >= 0x7FF) {
+    return -1;
+  }
+
   // Starting with a 53-bit number, IEEE 754 double-precision normal numbers
   // have an implicit mantissa bit. Mask that away and keep the low 52 bits.
   ret_mantissa &= 0x000FFFFFFFFFFFFF;
 
   // Pack the bits and return.
-  return ((int64_t)(ret_mantissa | (ret_exp2 << 52)));
+  return ((int64_t)(ret_mantissa | (((uint64_t)ret_exp2) << 52)));
+}
+
+// wuffs_private_impl__parse_number_f32_eisel_lemire is like
+// wuffs_private_impl__parse_number_f64_eisel_lemire but produces an IEEE 754
+// single-precision value. On success, it returns a non-negative int64_t such
+// that the low 31 bits hold the 8-bit exponent and 23-bit mantissa.
+//
+// On failure, it returns a negative value. Unlike the f64 version, this
+// includes when the result would be subnormal or infinite.
+//
+// Preconditions:
+//  - man is non-zero.
+//  - exp10 is in the range [-342 ..= 308], the parsing range of the
+//    wuffs_private_impl__powers_of_10 array.
+//
+// Only the top 25 bits of the 128-bit product matter, not the top 54 bits, so
+// the truncation error in the 64-bit approximation to (10 ** exp10) can only
+// matter when the next 38 bits are all on. In practice, the "high resolution"
+// 128-bit refinement (see the f64 version) is very rarely needed.
+static int64_t  //
+wuffs_private_impl__parse_number_f32_eisel_lemire(uint64_t man, int32_t exp10) {
+  const uint64_t* po10 = &wuffs_private_impl__powers_of_10[exp10 + 342][0];
+
+  uint32_t clz = wuffs_base__count_leading_zeroes_u64(man);
+  man <<= clz;
+
+  // The magic constant 191 = 127 + 64. The 127 is the f32 exponent bias. See
+  // the f64 version for the other magic constants.
+  int32_t ret_exp2 = ((217706 * exp10) >> 16) + 191 - ((int32_t)clz);
+
+  wuffs_base__multiply_u64__output x = wuffs_base__multiply_u64(man, po10[1]);
+  uint64_t x_hi = x.hi;
+  uint64_t x_lo = x.lo;
+
+  // Shifting x_hi right by either 38 or 39 bits will leave the top 39 MSBs
+  // (bits 25 ..= 63) off and the 40th MSB (bit 24) on. The carry from the
+  // upper bound's (man * 1) only matters if the low 38 bits are all on.
+  if (((x_hi & 0x3FFFFFFFFF) == 0x3FFFFFFFFF) && ((x_lo + man) < man)) {
+    wuffs_base__multiply_u64__output y = wuffs_base__multiply_u64(man, po10[0]);
+    uint64_t y_hi = y.hi;
+    uint64_t y_lo = y.lo;
+
+    uint64_t merged_hi = x_hi;
+    uint64_t merged_lo = x_lo + y_hi;
+    if (merged_lo < x_lo) {
+      merged_hi++;  // Carry the overflow bit.
+    }
+
+    if (((merged_hi & 0x3FFFFFFFFF) == 0x3FFFFFFFFF) &&
+        ((merged_lo + 1) == 0) && (y_lo + man < man)) {
+      return -1;
+    }
+
+    x_hi = merged_hi;
+    x_lo = merged_lo;
+  }
+
+  // Having bit 24 on (and higher bits off) means that ret_mantissa is a 25-bit
+  // number.
+  uint64_t msb = x_hi >> 63;
+  uint64_t ret_mantissa = x_hi >> (msb + 38);
+  ret_exp2 -= (int32_t)(1 ^ msb);
+
+  // Give up if we're exactly half-way between two representable numbers. The
+  // flat "102" (64 + 38) is simpler than "102 or 103, depending on msb".
+  if ((x_lo == 0) && ((x_hi & 0x3FFFFFFFFF) == 0) &&
+      ((ret_mantissa & 3) == 1)) {
+    return -1;
+  }
+
+  // Round to-nearest, from 25 to 24 bits, as per the f64 version.
+  ret_mantissa += ret_mantissa & 1;
+  ret_mantissa >>= 1;
+  if ((ret_mantissa >> 24) > 0) {
+    ret_mantissa >>= 1;
+    ret_exp2++;
+  }
+
+  // The biased exponent 0x00 means subnormal and 0xFF means infinite (or NaN).
+  // Leave those to the fallback.
+  if ((ret_exp2 <= 0) || (0xFF <= ret_exp2)) {
+    return -1;
+  }
+
+  // Starting with a 24-bit number, IEEE 754 single-precision normal numbers
+  // have an implicit mantissa bit. Mask that away and keep the low 23 bits.
+  ret_mantissa &= 0x007FFFFF;
+
+  // Pack the bits and return.
+  return ((int64_t)(ret_mantissa | (((uint64_t)ret_exp2) << 23)));
 }
 
 // --------
@@ -1776,45 +2449,322 @@ fail:
   } while (0);
 }
 
-static wuffs_base__result_f64  //
-wuffs_private_impl__high_prec_dec__to_f64(wuffs_private_impl__high_prec_dec* h,
-                                          uint32_t options) {
-  do {
-    // powers converts decimal powers of 10 to binary powers of 2. For example,
-    // (10000 >> 13) is 1. It stops before the elements exceed 60, also known
-    // as WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL.
-    //
-    // This rounds down (1<<13 is a lower bound for 1e4). Adding 1 to the array
-    // element value rounds up (1<<14 is an upper bound for 1e4) while staying
-    // at or below WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL.
-    //
-    // When starting in the range [1e+1 .. 1e+2] (i.e. h->decimal_point == +2),
-    // powers[2] == 6 and so:
-    //  - Right shifting by 6+0 produces the range [10/64 .. 100/64] =
-    //    [0.156250 .. 1.56250]. The resultant h->decimal_point is +0 or +1.
-    //  - Right shifting by 6+1 produces the range [10/128 .. 100/128] =
-    //    [0.078125 .. 0.78125]. The resultant h->decimal_point is -1 or -0.
-    //
-    // When starting in the range [1e-3 .. 1e-2] (i.e. h->decimal_point == -2),
-    // powers[2] == 6 and so:
-    //  - Left shifting by 6+0 produces the range [0.001*64 .. 0.01*64] =
-    //    [0.064 .. 0.64]. The resultant h->decimal_point is -1 or -0.
-    //  - Left shifting by 6+1 produces the range [0.001*128 .. 0.01*128] =
-    //    [0.128 .. 1.28]. The resultant h->decimal_point is +0 or +1.
-    //
-    // Thus, when targeting h->decimal_point being +0 or +1, use (powers[n]+0)
-    // when right shifting but (powers[n]+1) when left shifting.
-    static const uint32_t num_powers = 19;
-    static const uint8_t powers[19] = {
-        0,  3,  6,  9,  13, 16, 19, 23, 26, 29,  //
-        33, 36, 39, 43, 46, 49, 53, 56, 59,      //
-    };
+// --------
+
+// WUFFS_PRIVATE_IMPL__BIGINT__NUM_LIMBS is the capacity, in 32-bit limbs, of
+// a wuffs_private_impl__bigint. 4096 bits is enough for every comparison made
+// by wuffs_private_impl__high_prec_dec__to_f64__digit_comparison: the largest
+// is roughly (2**54 * 10**1126), as 1126 is 326 (the smallest
+// decimal_point before rounding to zero) plus 800 (the number of digits).
+#define WUFFS_PRIVATE_IMPL__BIGINT__NUM_LIMBS 128
+
+// wuffs_private_impl__bigint is a fixed capacity, arbitrary precision,
+// unsigned integer: limbs[.. num_limbs] in little-endian order. num_limbs is
+// zero for the number 0 and limbs[num_limbs - 1] is otherwise non-zero.
+//
+// Like the HPD type, it isn't for general purpose arithmetic, only for the
+// operations that float parsing needs. Those operations return false if the
+// result would exceed WUFFS_PRIVATE_IMPL__BIGINT__NUM_LIMBS.
+typedef struct wuffs_private_impl__bigint__struct {
+  uint32_t num_limbs;
+  uint32_t limbs[WUFFS_PRIVATE_IMPL__BIGINT__NUM_LIMBS];
+} wuffs_private_impl__bigint;
+
+static void  //
+wuffs_private_impl__bigint__set_u64(wuffs_private_impl__bigint* b, uint64_t x) {
+  b->num_limbs = 0;
+  for (; x; x >>= 32) {
+    b->limbs[b->num_limbs++] = (uint32_t)x;
+  }
+}
+
+// wuffs_private_impl__bigint__mul_add_u32 sets b to ((b * m) + a).
+static bool  //
+wuffs_private_impl__bigint__mul_add_u32(wuffs_private_impl__bigint* b,
+                                        uint32_t m,
+                                        uint32_t a) {
+  uint64_t carry = a;
+  uint32_t i;
+  for (i = 0; i < b->num_limbs; i++) {
+    carry += ((uint64_t)(b->limbs[i])) * m;
+    b->limbs[i] = (uint32_t)carry;
+    carry >>= 32;
+  }
+  if (carry) {
+    if (b->num_limbs >= WUFFS_PRIVATE_IMPL__BIGINT__NUM_LIMBS) {
+      return false;
+    }
+    b->limbs[b->num_limbs++] = (uint32_t)carry;
+  }
+  return true;
+}
+
+// wuffs_private_impl__bigint__mul_pow10 sets b to (b * (10 ** n)).
+static bool  //
+wuffs_private_impl__bigint__mul_pow10(wuffs_private_impl__bigint* b,
+                                      uint32_t n) {
+  for (; n >= 9; n -= 9) {
+    if (!wuffs_private_impl__bigint__mul_add_u32(b, 1000000000, 0)) {
+      return false;
+    }
+  }
+  static const uint32_t small_powers_of_10[9] = {
+      1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+  };
+  return wuffs_private_impl__bigint__mul_add_u32(b, small_powers_of_10[n], 0);
+}
+
+// wuffs_private_impl__bigint__lshift sets b to (b << n).
+static bool  //
+wuffs_private_impl__bigint__lshift(wuffs_private_impl__bigint* b, uint32_t n) {
+  if (b->num_limbs == 0) {
+    return true;
+  }
+  uint32_t limb_shift = n / 32;
+  uint32_t bit_shift = n % 32;
+  uint32_t top = bit_shift ? (b->limbs[b->num_limbs - 1] >> (32 - bit_shift))
+                           : 0;
+  uint32_t new_num_limbs = b->num_limbs + limb_shift + (top ? 1 : 0);
+  if (new_num_limbs > WUFFS_PRIVATE_IMPL__BIGINT__NUM_LIMBS) {
+    return false;
+  }
+  if (top) {
+    b->limbs[new_num_limbs - 1] = top;
+  }
+  uint32_t i = b->num_limbs;
+  while (i-- > 0) {
+    uint32_t x = b->limbs[i] << bit_shift;
+    if (bit_shift && (i > 0)) {
+      x |= b->limbs[i - 1] >> (32 - bit_shift);
+    }
+    b->limbs[i + limb_shift] = x;
+  }
+  memset(&b->limbs[0], 0, limb_shift * sizeof(uint32_t));
+  b->num_limbs = new_num_limbs;
+  return true;
+}
+
+// wuffs_private_impl__bigint__compare returns a negative, zero or positive
+// value when a is less than, equal to or greater than b.
+static int32_t  //
+wuffs_private_impl__bigint__compare(const wuffs_private_impl__bigint* a,
+                                    const wuffs_private_impl__bigint* b) {
+  if (a->num_limbs != b->num_limbs) {
+    return (a->num_limbs < b->num_limbs) ? -1 : +1;
+  }
+  uint32_t i = a->num_limbs;
+  while (i-- > 0) {
+    if (a->limbs[i] != b->limbs[i]) {
+      return (a->limbs[i] < b->limbs[i]) ? -1 : +1;
+    }
+  }
+  return 0;
+}
+
+// wuffs_private_impl__parse_number_f64_lower_bound returns the IEEE 754
+// bit representation of a (positive) f64 that is at or just below (man *
+// (10 ** exp10)): at most 2 ULP (Units in the Last Place) below.
+//
+// Like Eisel-Lemire, it multiplies man by the 64-bit mantissa of the
+// wuffs_private_impl__powers_of_10 entry, but it never gives up. Instead, it
+// truncates, as both man and the table entry are lower bounds. Combined, the
+// relative error is far less than the 2**-53 spacing of f64 values. Unlike
+// Eisel-Lemire, exp10 is not restricted to the table's range (it makes a
+// second multiplication if necessary) and the result can be infinite.
+//
+// Precondition: man is non-zero.
+static uint64_t  //
+wuffs_private_impl__parse_number_f64_lower_bound(uint64_t man, int32_t exp10) {
+  // The value is at least (m * (2 ** e2)).
+  uint32_t clz = wuffs_base__count_leading_zeroes_u64(man);
+  uint64_t m = man << clz;
+  int32_t e2 = -((int32_t)clz);
+  while (exp10 != 0) {
+    int32_t e = exp10;
+    if (e < -342) {
+      e = -342;
+    } else if (e > +308) {
+      e = +308;
+    }
+    exp10 -= e;
+
+    // The table entry for (10 ** e) is normalized: its value is
+    // (po10_hi * (2 ** po10_exp2)) with po10_hi's MSB on. The 217706 magic
+    // constant is discussed in wuffs_private_impl__parse_number_f64_eisel_lemire.
+    uint64_t po10_hi = wuffs_private_impl__powers_of_10[e + 342][1];
+    int32_t po10_exp2 = ((217706 * e) >> 16) - 63;
+    wuffs_base__multiply_u64__output x = wuffs_base__multiply_u64(m, po10_hi);
+    if ((x.hi >> 63) == 0) {
+      x.hi = (x.hi << 1) | (x.lo >> 63);
+      e2--;
+    }
+    m = x.hi;
+    e2 += 64 + po10_exp2;
+  }
+
+  // The value's MSB is bit number (63 + e2), counting from the units bit.
+  // Keep 53 bits, or fewer for subnormals.
+  int32_t msb = 63 + e2;
+  if (msb >= 1024) {
+    return 0x7FF0000000000000;
+  }
+  int32_t lsb = msb - 52;
+  if (lsb < -1074) {
+    lsb = -1074;
+  }
+  uint32_t shift = (uint32_t)(lsb - e2);
+  uint64_t bits = (shift < 64) ? (m >> shift) : 0;
+  if ((bits >> 52) == 0) {  // Subnormal or zero.
+    return bits;
+  }
+  return (bits & 0x000FFFFFFFFFFFFF) | (((uint64_t)(lsb + 1075)) << 52);
+}
+
+// wuffs_private_impl__high_prec_dec__to_f64__digit_comparison sets *bits to
+// the (positive) IEEE 754 bit representation of h, rounded to nearest, ties to
+// even. It returns false if it couldn't, leaving that to Simple Decimal
+// Conversion.
+//
+// It starts with a lower bound candidate, c, and compares h's exact digits
+// against the halfway point between c and the next f64 up. If h is above the
+// halfway point, increment c and repeat. As c starts at most 2 ULP low, this
+// loop runs at most 3 times. Each comparison is of two big integers, scaled
+// by powers of 2 and 10 so that neither side has a fractional part.
+//
+// This is much faster than Simple Decimal Conversion (repeatedly shifting
+// the 800-digit HPD) when the input has only a few more than 19 digits or is
+// a halfway case like "1e23", as the big integers are then small.
+//
+// Precondition: h->num_digits is non-zero and h->decimal_point is in the range
+// [-326 ..= +310].
+static bool  //
+wuffs_private_impl__high_prec_dec__to_f64__digit_comparison(
+    const wuffs_private_impl__high_prec_dec* h,
+    uint64_t* bits) {
+  uint32_t i_max = h->num_digits;
+  if (i_max > 19) {
+    i_max = 19;
+  }
+  uint64_t man = 0;
+  uint32_t i;
+  for (i = 0; i < i_max; i++) {
+    man = (10 * man) + h->digits[i];
+  }
+  if (man == 0) {
+    return false;
+  }
+  uint64_t c = wuffs_private_impl__parse_number_f64_lower_bound(
+      man, h->decimal_point - ((int32_t)i_max));
+
+  // h's value is (d * (10 ** exp10)) for the integer d.
+  wuffs_private_impl__bigint d;
+  d.num_limbs = 0;
+  for (i = 0; i < h->num_digits;) {
+    uint32_t chunk = 0;
+    uint32_t chunk_pow10 = 1;
+    for (; (i < h->num_digits) && (chunk_pow10 < 1000000000); i++) {
+      chunk = (10 * chunk) + h->digits[i];
+      chunk_pow10 *= 10;
+    }
+    if (!wuffs_private_impl__bigint__mul_add_u32(&d, chunk_pow10, chunk)) {
+      return false;
+    }
+  }
+  int32_t exp10 = h->decimal_point - ((int32_t)(h->num_digits));
+  if ((exp10 > 0) &&
+      !wuffs_private_impl__bigint__mul_pow10(&d, (uint32_t)exp10)) {
+    return false;
+  }
+
+  int loop_count;
+  for (loop_count = 0; loop_count < 3; loop_count++) {
+    if (c >= 0x7FF0000000000000) {
+      break;
+    }
+
+    // The halfway point between c and (c + 1), whose value is (c_man *
+    // (2 ** c_exp2)), is ((2 * c_man) + 1) * (2 ** (c_exp2 - 1)). That's true
+    // even when (c + 1) has a larger exponent (or is infinite).
+    uint64_t c_man = c & 0x000FFFFFFFFFFFFF;
+    int32_t c_exp2 = -1074;
+    if ((c >> 52) != 0) {
+      c_man |= 0x0010000000000000;
+      c_exp2 = ((int32_t)(c >> 52)) - 1075;
+    }
+    int32_t halfway_exp2 = c_exp2 - 1;
+
+    // Compare (d * (10 ** exp10)) with (halfway_man * (2 ** halfway_exp2)).
+    // Move the negative exponents to the other side.
+    wuffs_private_impl__bigint lhs = d;
+    wuffs_private_impl__bigint rhs;
+    wuffs_private_impl__bigint__set_u64(&rhs, (2 * c_man) + 1);
+    if ((exp10 < 0) &&
+        !wuffs_private_impl__bigint__mul_pow10(&rhs, (uint32_t)(-exp10))) {
+      return false;
+    }
+    if (!((halfway_exp2 < 0) ? wuffs_private_impl__bigint__lshift(
+                                   &lhs, (uint32_t)(-halfway_exp2))
+                             : wuffs_private_impl__bigint__lshift(
+                                   &rhs, (uint32_t)(+halfway_exp2)))) {
+      return false;
+    }
+
+    // Any truncated (non-zero) digits put h above its explicit digits.
+    int32_t cmp = wuffs_private_impl__bigint__compare(&lhs, &rhs);
+    if ((cmp > 0) || ((cmp == 0) && h->truncated)) {
+      c++;
+      continue;
+    } else if (cmp == 0) {
+      c += c & 1;
+    }
+    *bits = c;
+    return true;
+  }
+  *bits = c;
+  return c >= 0x7FF0000000000000;
+}
+
+static wuffs_base__result_f64  //
+wuffs_private_impl__high_prec_dec__to_f64(wuffs_private_impl__high_prec_dec* h,
+                                          uint32_t options) {
+  do {
+    // powers converts decimal powers of 10 to binary powers of 2. For example,
+    // (10000 >> 13) is 1. It stops before the elements exceed 60, also known
+    // as WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL.
+    //
+    // This rounds down (1<<13 is a lower bound for 1e4). Adding 1 to the array
+    // element value rounds up (1<<14 is an upper bound for 1e4) while staying
+    // at or below WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL.
+    //
+    // When starting in the range [1e+1 .. 1e+2] (i.e. h->decimal_point == +2),
+    // powers[2] == 6 and so:
+    //  - Right shifting by 6+0 produces the range [10/64 .. 100/64] =
+    //    [0.156250 .. 1.56250]. The resultant h->decimal_point is +0 or +1.
+    //  - Right shifting by 6+1 produces the range [10/128 .. 100/128] =
+    //    [0.078125 .. 0.78125]. The resultant h->decimal_point is -1 or -0.
+    //
+    // When starting in the range [1e-3 .. 1e-2] (i.e. h->decimal_point == -2),
+    // powers[2] == 6 and so:
+    //  - Left shifting by 6+0 produces the range [0.001*64 .. 0.01*64] =
+    //    [0.064 .. 0.64]. The resultant h->decimal_point is -1 or -0.
+    //  - Left shifting by 6+1 produces the range [0.001*128 .. 0.01*128] =
+    //    [0.128 .. 1.28]. The resultant h->decimal_point is +0 or +1.
+    //
+    // Thus, when targeting h->decimal_point being +0 or +1, use (powers[n]+0)
+    // when right shifting but (powers[n]+1) when left shifting.
+    static const uint32_t num_powers = 19;
+    static const uint8_t powers[19] = {
+        0,  3,  6,  9,  13, 16, 19, 23, 26, 29,  //
+        33, 36, 39, 43, 46, 49, 53, 56, 59,      //
+    };
 
     // Handle zero and obvious extremes. The largest and smallest positive
     // finite f64 values are approximately 1.8e+308 and 4.9e-324.
     if ((h->num_digits == 0) || (h->decimal_point < -326)) {
+      WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(fallback_extreme);
       goto zero;
     } else if (h->decimal_point > 310) {
+      WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(fallback_extreme);
       goto infinity;
     }
 
@@ -1833,7 +2783,7 @@ wuffs_private_impl__high_prec_dec__to_f64(wuffs_private_impl__high_prec_dec* h,
       i_max = 19;
     }
     int32_t exp10 = h->decimal_point - ((int32_t)i_max);
-    if ((-307 <= exp10) && (exp10 <= 288)) {
+    if ((-342 <= exp10) && (exp10 <= 308)) {
       uint64_t man = 0;
       uint32_t i;
       for (i = 0; i < i_max; i++) {
@@ -1851,6 +2801,7 @@ wuffs_private_impl__high_prec_dec__to_f64(wuffs_private_impl__high_prec_dec* h,
             break;
           }
         }
+        WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(fallback_eisel_lemire);
         wuffs_base__result_f64 ret;
         ret.status.repr = NULL;
         ret.value = wuffs_base__ieee_754_bit_representation__from_u64_to_f64(
@@ -1859,13 +2810,31 @@ wuffs_private_impl__high_prec_dec__to_f64(wuffs_private_impl__high_prec_dec* h,
       }
     }
 
-    // When Eisel-Lemire fails, fall back to Simple Decimal Conversion. See
+    // When Eisel-Lemire fails, compare big integers, which is usually much
+    // faster than Simple Decimal Conversion.
+    uint64_t dc_bits = 0;
+    if (wuffs_private_impl__high_prec_dec__to_f64__digit_comparison(
+            h, &dc_bits)) {
+      WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(fallback_digit_comparison);
+      if (dc_bits >= 0x7FF0000000000000) {
+        goto infinity;
+      }
+      wuffs_base__result_f64 ret;
+      ret.status.repr = NULL;
+      ret.value = wuffs_base__ieee_754_bit_representation__from_u64_to_f64(
+          dc_bits | (((uint64_t)(h->negative)) << 63));
+      return ret;
+    }
+
+    // As a last resort, fall back to Simple Decimal Conversion. See
     // https://nigeltao.github.io/blog/2020/parse-number-f64-simple.html
     //
     // Scale by powers of 2 until we're in the range [0.1 .. 10]. Equivalently,
     // that h->decimal_point is +0 or +1.
     //
     // First we shift right while at or above 10...
+    WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(
+        fallback_simple_decimal_conversion);
     const int32_t f64_bias = -1023;
     int32_t exp2 = 0;
     while (h->decimal_point > 1) {
@@ -2003,237 +2972,2553 @@ infinity:
   } while (0);
 }
 
-static inline bool  //
-wuffs_private_impl__is_decimal_digit(uint8_t c) {
-  return ('0' <= c) && (c <= '9');
-}
-
-static wuffs_base__result_f64  //
-wuffs_base__parse_number_f64(wuffs_base__slice_u8 s, uint32_t options) {
-  // In practice, almost all "dd.ddddE±xxx" numbers can be represented
-  // losslessly by a uint64_t mantissa "dddddd" and an int32_t base-10
-  // exponent, adjusting "xxx" for the position (if present) of the decimal
-  // separator '.' or ','.
-  //
-  // This (u64 man, i32 exp10) data structure is superficially similar to the
-  // "Do It Yourself Floating Point" type from Loitsch (†), but the exponent
-  // here is base-10, not base-2.
-  //
-  // If s's number fits in a (man, exp10), parse that pair with the
-  // Eisel-Lemire algorithm. If not, or if Eisel-Lemire fails, parsing s with
-  // the fallback algorithm is slower but comprehensive.
-  //
-  // † "Printing Floating-Point Numbers Quickly and Accurately with Integers"
-  // (https://www.cs.tufts.edu/~nr/cs257/archive/florian-loitsch/printf.pdf).
-  // Florian Loitsch is also the primary contributor to
-  // https://github.com/google/double-conversion
+// wuffs_private_impl__high_prec_dec__to_f32 is like
+// wuffs_private_impl__high_prec_dec__to_f64 but produces an IEEE 754
+// single-precision value. Converting directly (instead of converting to f64
+// and then narrowing) avoids double rounding.
+static wuffs_base__result_f32  //
+wuffs_private_impl__high_prec_dec__to_f32(wuffs_private_impl__high_prec_dec* h,
+                                          uint32_t options) {
   do {
-    // Calculating that (man, exp10) pair needs to stay within s's bounds.
-    // Provided that s isn't extremely long, work on a NUL-terminated copy of
-    // s's contents. The NUL byte isn't a valid part of "±dd.ddddE±xxx".
-    //
-    // As the pointer p walks the contents, it's faster to repeatedly check "is
-    // *p a valid digit" than "is p within bounds and *p a valid digit".
-    if (s.len >= 256) {
-      goto fallback;
-    }
-    uint8_t z[256];
-    memcpy(&z[0], s.ptr, s.len);
-    z[s.len] = 0;
-    const uint8_t* p = &z[0];
-
-    // Look for a leading minus sign. Technically, we could also look for an
-    // optional plus sign, but the "script/process-json-numbers.c with -p"
-    // benchmark is noticably slower if we do. It's optional and, in practice,
-    // usually absent. Let the fallback catch it.
-    bool negative = (*p == '-');
-    if (negative) {
-      p++;
-    }
-
-    // After walking "dd.dddd", comparing p later with p now will produce the
-    // number of "d"s and "."s.
-    const uint8_t* const start_of_digits_ptr = p;
+    // See wuffs_private_impl__high_prec_dec__to_f64 for what powers means.
+    static const uint32_t num_powers = 19;
+    static const uint8_t powers[19] = {
+        0,  3,  6,  9,  13, 16, 19, 23, 26, 29,  //
+        33, 36, 39, 43, 46, 49, 53, 56, 59,      //
+    };
 
-    // Walk the "d"s before a '.', 'E', NUL byte, etc. If it starts with '0',
-    // it must be a single '0'. If it starts with a non-zero decimal digit, it
-    // can be a sequence of decimal digits.
-    //
-    // Update the man variable during the walk. It's OK if man overflows now.
-    // We'll detect that later.
-    uint64_t man;
-    if (*p == '0') {
-      man = 0;
-      p++;
-      if (wuffs_private_impl__is_decimal_digit(*p)) {
-        goto fallback;
-      }
-    } else if (wuffs_private_impl__is_decimal_digit(*p)) {
-      man = ((uint8_t)(*p - '0'));
-      p++;
-      for (; wuffs_private_impl__is_decimal_digit(*p); p++) {
-        man = (10 * man) + ((uint8_t)(*p - '0'));
-      }
-    } else {
-      goto fallback;
+    // Handle zero and obvious extremes. The largest and smallest positive
+    // finite f32 values are approximately 3.4e+38 and 1.4e-45.
+    if ((h->num_digits == 0) || (h->decimal_point < -47)) {
+      goto zero;
+    } else if (h->decimal_point > 40) {
+      goto infinity;
     }
 
-    // Walk the "d"s after the optional decimal separator ('.' or ','),
-    // updating the man and exp10 variables.
-    int32_t exp10 = 0;
-    if (*p ==
-        ((options & WUFFS_BASE__PARSE_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA)
-             ? ','
-             : '.')) {
-      p++;
-      const uint8_t* first_after_separator_ptr = p;
-      if (!wuffs_private_impl__is_decimal_digit(*p)) {
-        goto fallback;
+    // Try the fast Eisel-Lemire algorithm again, as per the f64 version.
+    uint32_t i_max = h->num_digits;
+    if (i_max > 19) {
+      i_max = 19;
+    }
+    int32_t exp10 = h->decimal_point - ((int32_t)i_max);
+    if ((-342 <= exp10) && (exp10 <= 308)) {
+      uint64_t man = 0;
+      uint32_t i;
+      for (i = 0; i < i_max; i++) {
+        man = (10 * man) + h->digits[i];
       }
-      man = (10 * man) + ((uint8_t)(*p - '0'));
-      p++;
-      for (; wuffs_private_impl__is_decimal_digit(*p); p++) {
-        man = (10 * man) + ((uint8_t)(*p - '0'));
+      while (man != 0) {  // The 'while' is just an 'if' that we can 'break'.
+        int64_t r0 =
+            wuffs_private_impl__parse_number_f32_eisel_lemire(man + 0, exp10);
+        if (r0 < 0) {
+          break;
+        } else if (h->num_digits > 19) {
+          int64_t r1 =
+              wuffs_private_impl__parse_number_f32_eisel_lemire(man + 1, exp10);
+          if (r1 != r0) {
+            break;
+          }
+        }
+        wuffs_base__result_f32 ret;
+        ret.status.repr = NULL;
+        ret.value = wuffs_base__ieee_754_bit_representation__from_u32_to_f32(
+            ((uint32_t)r0) | (((uint32_t)(h->negative)) << 31));
+        return ret;
       }
-      exp10 = ((int32_t)(first_after_separator_ptr - p));
     }
 
-    // Count the number of digits:
-    //  - for an input of "314159",  digit_count is 6.
-    //  - for an input of "3.14159", digit_count is 7.
-    //
-    // This is off-by-one if there is a decimal separator. That's OK for now.
-    // We'll correct for that later. The "script/process-json-numbers.c with
-    // -p" benchmark is noticably slower if we try to correct for that now.
-    uint32_t digit_count = (uint32_t)(p - start_of_digits_ptr);
+    // When Eisel-Lemire fails, fall back to Simple Decimal Conversion. Scale
+    // by powers of 2 until h->decimal_point is +0 or +1.
+    const int32_t f32_bias = -127;
+    int32_t exp2 = 0;
+    while (h->decimal_point > 1) {
+      uint32_t n = (uint32_t)(+h->decimal_point);
+      uint32_t shift = (n < num_powers)
+                           ? powers[n]
+                           : WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL;
 
-    // Update exp10 for the optional exponent, starting with 'E' or 'e'.
-    if ((*p | 0x20) == 'e') {
-      p++;
-      int32_t exp_sign = +1;
-      if (*p == '-') {
-        p++;
-        exp_sign = -1;
-      } else if (*p == '+') {
-        p++;
-      }
-      if (!wuffs_private_impl__is_decimal_digit(*p)) {
-        goto fallback;
-      }
-      int32_t exp_num = ((uint8_t)(*p - '0'));
-      p++;
-      // The rest of the exp_num walking has a peculiar control flow but, once
-      // again, the "script/process-json-numbers.c with -p" benchmark is
-      // sensitive to alternative formulations.
-      if (wuffs_private_impl__is_decimal_digit(*p)) {
-        exp_num = (10 * exp_num) + ((uint8_t)(*p - '0'));
-        p++;
-      }
-      if (wuffs_private_impl__is_decimal_digit(*p)) {
-        exp_num = (10 * exp_num) + ((uint8_t)(*p - '0'));
-        p++;
-      }
-      while (wuffs_private_impl__is_decimal_digit(*p)) {
-        if (exp_num > 0x1000000) {
-          goto fallback;
-        }
-        exp_num = (10 * exp_num) + ((uint8_t)(*p - '0'));
-        p++;
+      wuffs_private_impl__high_prec_dec__small_rshift(h, shift);
+      if (h->decimal_point < -WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE) {
+        goto zero;
       }
-      exp10 += exp_sign * exp_num;
+      exp2 += (int32_t)shift;
     }
+    while (h->decimal_point < 0) {
+      uint32_t shift;
+      uint32_t n = (uint32_t)(-h->decimal_point);
+      shift = (n < num_powers)
+                  ? (powers[n] + 1u)
+                  : WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL;
 
-    // The Wuffs API is that the original slice has no trailing data. It also
-    // allows underscores, which we don't catch here but the fallback should.
-    if (p != &z[s.len]) {
-      goto fallback;
+      wuffs_private_impl__high_prec_dec__small_lshift(h, shift);
+      if (h->decimal_point > +WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE) {
+        goto infinity;
+      }
+      exp2 -= (int32_t)shift;
     }
 
-    // Check that the uint64_t typed man variable has not overflowed, based on
-    // digit_count.
-    //
-    // For reference:
-    //   - (1 << 63) is  9223372036854775808, which has 19 decimal digits.
-    //   - (1 << 64) is 18446744073709551616, which has 20 decimal digits.
-    //   - 19 nines,  9999999999999999999, is  0x8AC7230489E7FFFF, which has 64
-    //     bits and 16 hexadecimal digits.
-    //   - 20 nines, 99999999999999999999, is 0x56BC75E2D630FFFFF, which has 67
-    //     bits and 17 hexadecimal digits.
-    if (digit_count > 19) {
-      // Even if we have more than 19 pseudo-digits, it's not yet definitely an
-      // overflow. Recall that digit_count might be off-by-one (too large) if
-      // there's a decimal separator. It will also over-report the number of
-      // meaningful digits if the input looks something like "0.000dddExxx".
-      //
-      // We adjust by the number of leading '0's and '.'s and re-compare to 19.
-      // Once again, technically, we could skip ','s too, but that perturbs the
-      // "script/process-json-numbers.c with -p" benchmark.
-      const uint8_t* q = start_of_digits_ptr;
-      for (; (*q == '0') || (*q == '.'); q++) {
+    // Get from "in the range [0.1 .. 10]" to "in the range [1 .. 2]". The
+    // final left shift is 23 (the number of explicit f32 bits) plus an
+    // additional adjustment.
+    int man3 = (100 * h->digits[0]) +
+               ((h->num_digits > 1) ? (10 * h->digits[1]) : 0) +
+               ((h->num_digits > 2) ? h->digits[2] : 0);
+    int32_t additional_lshift = 0;
+    if (h->decimal_point == 0) {  // The value is in [0.1 .. 1].
+      if (man3 < 125) {
+        additional_lshift = +4;
+      } else if (man3 < 250) {
+        additional_lshift = +3;
+      } else if (man3 < 500) {
+        additional_lshift = +2;
+      } else {
+        additional_lshift = +1;
+      }
+    } else {  // The value is in [1 .. 10].
+      if (man3 < 200) {
+        additional_lshift = -0;
+      } else if (man3 < 400) {
+        additional_lshift = -1;
+      } else if (man3 < 800) {
+        additional_lshift = -2;
+      } else {
+        additional_lshift = -3;
       }
-      digit_count -= (uint32_t)(q - start_of_digits_ptr);
-      if (digit_count > 19) {
-        goto fallback;
+    }
+    exp2 -= additional_lshift;
+    uint32_t final_lshift = (uint32_t)(23 + additional_lshift);
+
+    // The minimum normal exponent is (f32_bias + 1).
+    while ((f32_bias + 1) > exp2) {
+      uint32_t n = (uint32_t)((f32_bias + 1) - exp2);
+      if (n > WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL) {
+        n = WUFFS_PRIVATE_IMPL__HPD__SHIFT__MAX_INCL;
       }
+      wuffs_private_impl__high_prec_dec__small_rshift(h, n);
+      exp2 += (int32_t)n;
     }
 
-    // The wuffs_private_impl__parse_number_f64_eisel_lemire preconditions
-    // include that exp10 is in the range [-307 ..= 288].
-    if ((exp10 < -307) || (288 < exp10)) {
-      goto fallback;
+    // Check for overflow.
+    if ((exp2 - f32_bias) >= 0x00FF) {  // (1 << 8) - 1.
+      goto infinity;
     }
 
-    // If both man and (10 ** exp10) are exactly representable by a double, we
-    // don't need to run the Eisel-Lemire algorithm.
-    if ((-22 <= exp10) && (exp10 <= 22) && ((man >> 53) == 0)) {
-      double d = (double)man;
-      if (exp10 >= 0) {
-        d *= wuffs_private_impl__f64_powers_of_10[+exp10];
-      } else {
-        d /= wuffs_private_impl__f64_powers_of_10[-exp10];
+    // Extract 24 bits for the mantissa (in base-2).
+    wuffs_private_impl__high_prec_dec__small_lshift(h, final_lshift);
+    uint64_t man2 = wuffs_private_impl__high_prec_dec__rounded_integer(h);
+
+    // Rounding might have added one bit. If so, shift and re-check overflow.
+    if ((man2 >> 24) != 0) {
+      man2 >>= 1;
+      exp2++;
+      if ((exp2 - f32_bias) >= 0x00FF) {  // (1 << 8) - 1.
+        goto infinity;
       }
-      wuffs_base__result_f64 ret;
-      ret.status.repr = NULL;
-      ret.value = negative ? -d : +d;
-      return ret;
     }
 
-    // The wuffs_private_impl__parse_number_f64_eisel_lemire preconditions
-    // include that man is non-zero. Parsing "0" should be caught by the "If
-    // both man and (10 ** exp10)" above, but "0e99" might not.
-    if (man == 0) {
-      goto fallback;
+    // Handle subnormal numbers.
+    if ((man2 >> 23) == 0) {
+      exp2 = f32_bias;
     }
 
-    // Our man and exp10 are in range. Run the Eisel-Lemire algorithm.
-    int64_t r = wuffs_private_impl__parse_number_f64_eisel_lemire(man, exp10);
-    if (r < 0) {
-      goto fallback;
-    }
-    wuffs_base__result_f64 ret;
+    // Pack the bits and return.
+    uint32_t exp2_bits = (uint32_t)((exp2 - f32_bias) & 0x00FF);
+    uint32_t bits = ((uint32_t)(man2 & 0x007FFFFF)) |  // (1 << 23) - 1.
+                    (exp2_bits << 23) |                //
+                    (h->negative ? 0x80000000 : 0);    // (1 << 31).
+
+    wuffs_base__result_f32 ret;
     ret.status.repr = NULL;
-    ret.value = wuffs_base__ieee_754_bit_representation__from_u64_to_f64(
-        ((uint64_t)r) | (((uint64_t)negative) << 63));
+    ret.value = wuffs_base__ieee_754_bit_representation__from_u32_to_f32(bits);
     return ret;
   } while (0);
 
-fallback:
+zero:
   do {
-    wuffs_private_impl__high_prec_dec h;
-    wuffs_base__status status =
-        wuffs_private_impl__high_prec_dec__parse(&h, s, options);
-    if (status.repr) {
-      return wuffs_private_impl__parse_number_f64_special(s, options);
+    uint32_t bits = h->negative ? 0x80000000 : 0;
+
+    wuffs_base__result_f32 ret;
+    ret.status.repr = NULL;
+    ret.value = wuffs_base__ieee_754_bit_representation__from_u32_to_f32(bits);
+    return ret;
+  } while (0);
+
+infinity:
+  do {
+    if (options & WUFFS_BASE__PARSE_NUMBER_FXX__REJECT_INF_AND_NAN) {
+      wuffs_base__result_f32 ret;
+      ret.status.repr = wuffs_base__error__bad_argument;
+      ret.value = 0;
+      return ret;
+    }
+
+    uint32_t bits = h->negative ? 0xFF800000 : 0x7F800000;
+
+    wuffs_base__result_f32 ret;
+    ret.status.repr = NULL;
+    ret.value = wuffs_base__ieee_754_bit_representation__from_u32_to_f32(bits);
+    return ret;
+  } while (0);
+}
+
+static inline bool  //
+wuffs_private_impl__is_decimal_digit(uint8_t c) {
+  return ('0' <= c) && (c <= '9');
+}
+
+// wuffs_private_impl__man_exp10 is a decimal number, (man * (10 ** exp10)),
+// negated if negative is true.
+//
+// If truncated is true, man holds only the first 19 significant digits and
+// there were further, dropped, non-zero digits. The exact (absolute) value is
+// then strictly between (man * (10 ** exp10)) and ((man + 1) * (10 ** exp10)).
+//
+// This (u64 man, i32 exp10) data structure is superficially similar to the
+// "Do It Yourself Floating Point" type from Loitsch (†), but the exponent
+// here is base-10, not base-2.
+//
+// † "Printing Floating-Point Numbers Quickly and Accurately with Integers"
+// (https://www.cs.tufts.edu/~nr/cs257/archive/florian-loitsch/printf.pdf).
+// Florian Loitsch is also the primary contributor to
+// https://github.com/google/double-conversion
+typedef struct wuffs_private_impl__man_exp10__struct {
+  uint64_t man;
+  int32_t exp10;
+  bool negative;
+  bool truncated;
+} wuffs_private_impl__man_exp10;
+
+// wuffs_private_impl__is_eight_decimal_digits returns whether all 8 bytes of
+// u, a little-endian load of 8 bytes, are ASCII decimal digits. SWAR (SIMD
+// Within A Register) means that it checks them all at once, without branches.
+//
+// A byte is in ['0' ..= '9'], i.e. [0x30 ..= 0x39], if and only if its high
+// nibble is 3 and adding 6 to it does not carry into the high nibble.
+static inline bool  //
+wuffs_private_impl__is_eight_decimal_digits(uint64_t u) {
+  return ((u & 0xF0F0F0F0F0F0F0F0) |
+          (((u + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+// wuffs_private_impl__num_leading_decimal_digits returns how many of u's bytes,
+// counting from the low byte, are ASCII decimal digits before the first byte
+// that isn't. It returns 8 if they all are.
+//
+// It uses the same test as wuffs_private_impl__is_eight_decimal_digits. Adding
+// 0x06 to a byte can carry into the next byte, but only if the former byte is
+// not a digit, so that carry cannot change the answer.
+static inline uint32_t  //
+wuffs_private_impl__num_leading_decimal_digits(uint64_t u) {
+  uint64_t non_digits =
+      ((u & 0xF0F0F0F0F0F0F0F0) |
+       (((u + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ^
+      0x3333333333333333;
+  return wuffs_base__count_trailing_zeroes_u64(non_digits) >> 3;
+}
+
+// wuffs_private_impl__parse_eight_decimal_digits converts u, a little-endian
+// load of 8 ASCII decimal digits, to the number those digits represent. For
+// example, loading "12345678" produces 12345678.
+//
+// Instead of 8 serially dependent multiply-adds, it combines adjacent digits
+// into 2-digit, 4-digit and then 8-digit numbers, 3 steps in all. See
+// https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+//
+// Precondition: wuffs_private_impl__is_eight_decimal_digits(u) is true.
+static inline uint32_t  //
+wuffs_private_impl__parse_eight_decimal_digits(uint64_t u) {
+  // Each byte now holds a value in [0 ..= 9]. The first digit is the low byte.
+  u -= 0x3030303030303030;
+  // Each odd-indexed byte now holds a 2-digit number in [0 ..= 99].
+  u = (u * 10) + (u >> 8);
+  // The two 4-digit numbers (each from a pair of 2-digit numbers, multiplied
+  // by 100 and 1 or by 1000000 and 10000) are summed into the high 32 bits.
+  u = (((u & 0x000000FF000000FF) * 0x000F424000000064) +
+       (((u >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >>
+      32;
+  return (uint32_t)u;
+}
+
+// wuffs_private_impl__u64_powers_of_10 holds the powers of 10 up to 1e16.
+static const uint64_t wuffs_private_impl__u64_powers_of_10[17] = {
+    1u,
+    10u,
+    100u,
+    1000u,
+    10000u,
+    100000u,
+    1000000u,
+    10000000u,
+    100000000u,
+    1000000000u,
+    10000000000u,
+    100000000000u,
+    1000000000000u,
+    10000000000000u,
+    100000000000000u,
+    1000000000000000u,
+    10000000000000000u,
+};
+
+// wuffs_private_impl__is_decimal_digit_before returns whether p is before q
+// and *p is a decimal digit.
+static inline bool  //
+wuffs_private_impl__is_decimal_digit_before(const uint8_t* p,
+                                             const uint8_t* q) {
+  return (p < q) && wuffs_private_impl__is_decimal_digit(*p);
+}
+
+// wuffs_private_impl__parse_number__scan_digits__portable walks the run of
+// decimal digits starting at p (and ending at or before q), accumulating them
+// into *man. It returns a pointer to the first byte after that run. It's OK if
+// *man overflows, as per wuffs_private_impl__parse_number__scan_man_exp10.
+//
+// It converts 8 digits at a time when it can, which shortens the serial
+// dependency chain of (10 * man) + digit updates from 1 per digit to 1 per 8
+// digits. If padded is false, the last (fewer than 8) digits are converted one
+// at a time. If padded is true, the precondition is that the
+// WUFFS_BASE__PARSE_NUMBER_FXX__NUM_PADDING_BYTES bytes starting at q are
+// readable, so that every load can be a whole uint64_t and the last digits are
+// converted all at once by masking off the bytes that follow them.
+//
+// padded is expected to be a compile-time constant.
+static inline const uint8_t*  //
+wuffs_private_impl__parse_number__scan_digits__portable(uint64_t* man,
+                                                        const uint8_t* p,
+                                                        const uint8_t* q,
+                                                        bool padded) {
+  uint64_t m = *man;
+  if (padded) {
+    while (true) {
+      uint64_t u = wuffs_base__peek_u64le__no_bounds_check(p);
+      uint32_t n = wuffs_private_impl__num_leading_decimal_digits(u);
+      if (((size_t)(q - p)) < n) {
+        n = (uint32_t)(q - p);
+      }
+      if (n == 8) {
+        m = (100000000 * m) + wuffs_private_impl__parse_eight_decimal_digits(u);
+        p += 8;
+        continue;
+      } else if (n > 0) {
+        // Shift the n digits to the high end, filling the low (leading) end
+        // with '0's. For example, "123,xyz_" becomes "00000123".
+        u = (u << (64 - (8 * n))) | (0x3030303030303030 >> (8 * n));
+        m = (wuffs_private_impl__u64_powers_of_10[n] * m) +
+            wuffs_private_impl__parse_eight_decimal_digits(u);
+        p += n;
+      }
+      break;
+    }
+  } else {
+    for (; ((q - p) >= 8) && wuffs_private_impl__is_eight_decimal_digits(
+                                 wuffs_base__peek_u64le__no_bounds_check(p));
+         p += 8) {
+      m = (100000000 * m) + wuffs_private_impl__parse_eight_decimal_digits(
+                                wuffs_base__peek_u64le__no_bounds_check(p));
+    }
+    for (; wuffs_private_impl__is_decimal_digit_before(p, q); p++) {
+      m = (10 * m) + ((uint8_t)(*p - '0'));
+    }
+  }
+  *man = m;
+  return p;
+}
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+
+// wuffs_private_impl__parse_number__x86_shift_table, loaded from at offset n
+// and used as a _mm_shuffle_epi8 mask, moves the low n bytes of a 128-bit
+// register to its high end, zeroing the low (16 - n) bytes.
+static const uint8_t wuffs_private_impl__parse_number__x86_shift_table[32] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  //
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  //
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,  //
+    0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,  //
+};
+
+// wuffs_private_impl__parse_number__x86_keep_table, loaded from at offset n
+// and used as a _mm_and_si128 mask, keeps the high n bytes of a 128-bit
+// register, zeroing the low (16 - n) bytes.
+static const uint8_t wuffs_private_impl__parse_number__x86_keep_table[32] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,  //
+};
+
+// wuffs_private_impl__parse_sixteen_decimal_digits__x86_sse41 converts v, 16
+// bytes each holding a value in [0 ..= 9] (the first digit in the low byte),
+// to the number those digits represent. Like
+// wuffs_private_impl__parse_eight_decimal_digits, it combines adjacent digits
+// into 2-digit, 4-digit and then 8-digit numbers, but with multiply-add
+// instructions instead of SWAR tricks.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("sse4.1")
+static inline uint64_t  //
+wuffs_private_impl__parse_sixteen_decimal_digits__x86_sse41(__m128i v) {
+  // 8 lanes of uint16_t, each in [0 ..= 99].
+  v = _mm_maddubs_epi16(v, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1,  //
+                                         10, 1, 10, 1, 10, 1, 10, 1));
+  // 4 lanes of uint32_t, each in [0 ..= 9999].
+  v = _mm_madd_epi16(v, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+  // 8 lanes of uint16_t: the 4 previous lanes, twice over.
+  v = _mm_packus_epi32(v, v);
+  // 4 lanes of uint32_t, each in [0 ..= 99999999]. Only the low 2 matter.
+  v = _mm_madd_epi16(v, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+  uint64_t x = (uint64_t)_mm_cvtsi128_si64(v);
+  return ((x & 0xFFFFFFFF) * 100000000) + (x >> 32);
+}
+
+// wuffs_private_impl__parse_number__scan_digits__x86_sse41 is like
+// wuffs_private_impl__parse_number__scan_digits__portable but it classifies
+// and converts 16 digits at a time.
+//
+// Precondition: the 16 bytes starting at p are readable. When padded is
+// false, that means (q - p) >= 16. When padded is true, (q - p) >= 8 is
+// enough.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("sse4.1")
+static inline const uint8_t*  //
+wuffs_private_impl__parse_number__scan_digits__x86_sse41(uint64_t* man,
+                                                         const uint8_t* p,
+                                                         const uint8_t* q,
+                                                         bool padded) {
+  uint64_t m = *man;
+  while (true) {
+    __m128i v = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)(const void*)p),
+                             _mm_set1_epi8('0'));
+    // A byte is a digit if and only if, after subtracting '0', it is in
+    // [0 ..= 9] as an unsigned value.
+    uint32_t digits = (uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(9)), v));
+    uint32_t n = wuffs_base__count_trailing_zeroes_u64(~digits & 0x1FFFF);
+    if (((size_t)(q - p)) < n) {
+      n = (uint32_t)(q - p);
+    }
+    if (n == 16) {
+      m = (10000000000000000u * m) +
+          wuffs_private_impl__parse_sixteen_decimal_digits__x86_sse41(v);
+      p += 16;
+      if (((size_t)(q - p)) >= (padded ? 8u : 16u)) {
+        continue;
+      }
+      *man = m;
+      return wuffs_private_impl__parse_number__scan_digits__portable(man, p, q,
+                                                                     padded);
+    } else if (n > 0) {
+      v = _mm_shuffle_epi8(
+          v, _mm_loadu_si128(
+                 (const __m128i*)(const void*)(
+                     wuffs_private_impl__parse_number__x86_shift_table + n)));
+      m = (wuffs_private_impl__u64_powers_of_10[n] * m) +
+          wuffs_private_impl__parse_sixteen_decimal_digits__x86_sse41(v);
+      p += n;
+    }
+    break;
+  }
+  *man = m;
+  return p;
+}
+
+// wuffs_private_impl__parse_number__parse_run__x86_sse41 converts the n
+// (in [1 ..= 16]) decimal digits starting at run. It loads the 16 bytes
+// starting at run if that stays within window_end. Otherwise, it loads the 16
+// bytes ending at (run + n), so those must be readable.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("sse4.1")
+static inline uint64_t  //
+wuffs_private_impl__parse_number__parse_run__x86_sse41(
+    const uint8_t* run,
+    uint32_t n,
+    const uint8_t* window_end) {
+  __m128i v;
+  if ((window_end - run) >= 16) {
+    v = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i*)(const void*)run),
+        _mm_loadu_si128((const __m128i*)(const void*)(
+            wuffs_private_impl__parse_number__x86_shift_table + n)));
+  } else {
+    v = _mm_and_si128(
+        _mm_loadu_si128((const __m128i*)(const void*)(run + n - 16)),
+        _mm_loadu_si128((const __m128i*)(const void*)(
+            wuffs_private_impl__parse_number__x86_keep_table + n)));
+  }
+  // The zeroed bytes are now '\x00', not '0', so subtracting '0' from them
+  // would not produce 0. Saturating subtraction does.
+  v = _mm_subs_epu8(v, _mm_set1_epi8('0'));
+  return wuffs_private_impl__parse_sixteen_decimal_digits__x86_sse41(v);
+}
+
+// wuffs_private_impl__parse_number__scan_mantissa__x86_avx2 walks the "dd" or
+// "dd.dddd" part of a number starting at p, setting *man and *exp10 and
+// returning a pointer to the first byte after that part. It classifies the
+// next 32 bytes all at once, finding where the integral and fractional runs
+// of digits start and end without a per-byte loop.
+//
+// It returns NULL, leaving the scalar code to do the work (including
+// rejecting invalid input), unless it has a fast answer: each run has between
+// 1 and 16 digits, a leading '0' is a lone '0' and the number ends inside the
+// 32-byte window.
+//
+// Precondition: the 32 bytes starting at p are readable and (q - p) >= 1.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("avx2")
+static inline const uint8_t*  //
+wuffs_private_impl__parse_number__scan_mantissa__x86_avx2(uint64_t* man,
+                                                          int32_t* exp10,
+                                                          const uint8_t* p,
+                                                          const uint8_t* q,
+                                                          uint8_t separator) {
+  __m256i v = _mm256_sub_epi8(
+      _mm256_loadu_si256((const __m256i*)(const void*)p), _mm256_set1_epi8('0'));
+  uint64_t digits = (uint32_t)_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(9)), v));
+  uint64_t separators = (uint32_t)_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(v, _mm256_set1_epi8((char)(separator - '0'))));
+  if (((size_t)(q - p)) < 32) {
+    uint64_t in_bounds = (((uint64_t)1) << (q - p)) - 1;
+    digits &= in_bounds;
+    separators &= in_bounds;
+  }
+
+  // Bits at or above 32 are set in ~digits, so that n0 and n1 are at most 32.
+  uint32_t n0 = wuffs_base__count_trailing_zeroes_u64(~digits);
+  if ((n0 == 0) || (n0 > 16) || ((n0 > 1) && (*p == '0'))) {
+    return NULL;
+  }
+  const uint8_t* window_end = p + 32;
+  uint64_t m =
+      wuffs_private_impl__parse_number__parse_run__x86_sse41(p, n0, window_end);
+
+  if (!((separators >> n0) & 1)) {
+    *man = m;
+    *exp10 = 0;
+    return p + n0;
+  }
+
+  uint32_t n1 = wuffs_base__count_trailing_zeroes_u64(~(digits >> (n0 + 1)));
+  if ((n1 == 0) || (n1 > 16) || ((n0 + 1 + n1) >= 32)) {
+    return NULL;
+  }
+  *man = (wuffs_private_impl__u64_powers_of_10[n1] * m) +
+         wuffs_private_impl__parse_number__parse_run__x86_sse41(
+             p + n0 + 1, n1, window_end);
+  *exp10 = -((int32_t)n1);
+  return p + n0 + 1 + n1;
+}
+
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+
+// wuffs_private_impl__parse_number__scan_digits has the same contract as
+// wuffs_private_impl__parse_number__scan_digits__portable, but uses SIMD
+// instructions when the CPU supports them and there's room to load 16 bytes.
+static inline const uint8_t*  //
+wuffs_private_impl__parse_number__scan_digits(uint64_t* man,
+                                              const uint8_t* p,
+                                              const uint8_t* q,
+                                              bool padded) {
+#if defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+  if ((((size_t)(q - p)) >= (padded ? 8u : 16u)) &&
+      wuffs_base__cpu_arch__have_x86_sse41()) {
+    return wuffs_private_impl__parse_number__scan_digits__x86_sse41(man, p, q,
+                                                                    padded);
+  }
+#endif
+  return wuffs_private_impl__parse_number__scan_digits__portable(man, p, q,
+                                                                 padded);
+}
+
+// wuffs_private_impl__are_all_zero_digits returns whether every byte in [p ..
+// q) is a '0'.
+static inline bool  //
+wuffs_private_impl__are_all_zero_digits(const uint8_t* p, const uint8_t* q) {
+  for (; (q - p) >= 8; p += 8) {
+    if (wuffs_base__peek_u64le__no_bounds_check(p) != 0x3030303030303030) {
+      return false;
+    }
+  }
+  for (; p < q; p++) {
+    if (*p != '0') {
+      return false;
+    }
+  }
+  return true;
+}
+
+// wuffs_private_impl__parse_number__scan_man_exp10 walks a "±dd.ddddE±xxx"
+// number starting at p and ending at or before q, regardless of what comes
+// after q, storing its value in *dst.
+//
+// It returns a pointer to the first byte after the number, or NULL if the
+// input isn't in the subset of the grammar that the fast path handles (e.g.
+// it is "inf", "nan" or a bare "."). It does not look at what follows the
+// number: whether that trailing data is acceptable is the caller's decision.
+//
+// It reads s in place. An earlier version worked on a NUL-terminated copy, so
+// that checking "is *p a valid digit" didn't also need "is p within bounds".
+// But loading 8 bytes at a time from a freshly written copy stalls on
+// store-to-load forwarding, which costs more than the bounds checks save.
+//
+// See wuffs_private_impl__parse_number__scan_digits__portable for what padded
+// means.
+static WUFFS_BASE__FORCE_INLINE const uint8_t*  //
+wuffs_private_impl__parse_number__scan_man_exp10(
+    wuffs_private_impl__man_exp10* dst,
+    const uint8_t* p,
+    const uint8_t* q,
+    uint32_t options,
+    bool padded) {
+  // Look for a leading sign. An explicit plus sign is rare in general, but
+  // common in some feeds, so accept it here rather than in the fallback.
+  // Testing for it only after the minus sign keeps the "script/process-json-
+  // numbers.c with -p" benchmark, which has many negative numbers, as fast as
+  // before.
+  bool negative = (p < q) && (*p == '-');
+  if (negative) {
+    p++;
+  } else if ((p < q) && (*p == '+')) {
+    p++;
+  }
+
+  // After walking "dd.dddd", comparing p later with p now will produce the
+  // number of "d"s and "."s.
+  const uint8_t* const start_of_digits_ptr = p;
+
+  // Walk the "d"s before a '.', 'E', end of input, etc. If it starts with
+  // '0', it must be a single '0' (unless the ALLOW_MULTIPLE_LEADING_ZEROES
+  // option is set). If it starts with a non-zero decimal digit, it can be a
+  // sequence of decimal digits.
+  //
+  // Update the man variable during the walk. It's OK if man overflows now.
+  // We'll detect that later.
+  uint64_t man = 0;
+  int32_t exp10 = 0;
+  const uint8_t separator =
+      (options & WUFFS_BASE__PARSE_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA)
+          ? ','
+          : '.';
+  if (p >= q) {
+    return NULL;
+  }
+#if defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+  // With AVX2, try to find and convert all of "dd.dddd" at once. If that
+  // punts (returning NULL), fall through to the walk below.
+  if ((((size_t)(q - p)) >= (padded ? 24u : 32u)) &&
+      wuffs_base__cpu_arch__have_x86_avx2()) {
+    const uint8_t* r = wuffs_private_impl__parse_number__scan_mantissa__x86_avx2(
+        &man, &exp10, p, q, separator);
+    if (r) {
+      p = r;
+      goto after_mantissa;
+    }
+  }
+#endif
+  if ((*p == '0') &&
+      !(options &
+        WUFFS_BASE__PARSE_NUMBER_XXX__ALLOW_MULTIPLE_LEADING_ZEROES)) {
+    p++;
+    if (wuffs_private_impl__is_decimal_digit_before(p, q)) {
+      return NULL;
+    }
+  } else if (wuffs_private_impl__is_decimal_digit(*p)) {
+    p = wuffs_private_impl__parse_number__scan_digits(&man, p, q, padded);
+  } else {
+    return NULL;
+  }
+
+  // Walk the "d"s after the optional decimal separator ('.' or ','),
+  // updating the man and exp10 variables.
+  if ((p < q) && (*p == separator)) {
+    p++;
+    const uint8_t* first_after_separator_ptr = p;
+    p = wuffs_private_impl__parse_number__scan_digits(&man, p, q, padded);
+    if (p == first_after_separator_ptr) {
+      return NULL;
+    }
+    exp10 = ((int32_t)(first_after_separator_ptr - p));
+  }
+#if defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+after_mantissa:;
+#endif
+
+  // Count the number of digits:
+  //  - for an input of "314159",  digit_count is 6.
+  //  - for an input of "3.14159", digit_count is 7.
+  //
+  // This is off-by-one if there is a decimal separator. That's OK for now.
+  // We'll correct for that later. The "script/process-json-numbers.c with
+  // -p" benchmark is noticably slower if we try to correct for that now.
+  uint32_t digit_count = (uint32_t)(p - start_of_digits_ptr);
+  const uint8_t* const end_of_digits_ptr = p;
+
+  // Update exp10 for the optional exponent, starting with 'E' or 'e'.
+  if ((p < q) && ((*p | 0x20) == 'e')) {
+    p++;
+    int32_t exp_sign = +1;
+    if ((p < q) && (*p == '-')) {
+      p++;
+      exp_sign = -1;
+    } else if ((p < q) && (*p == '+')) {
+      p++;
+    }
+    if (!wuffs_private_impl__is_decimal_digit_before(p, q)) {
+      return NULL;
+    }
+    int32_t exp_num = ((uint8_t)(*p - '0'));
+    p++;
+    // The rest of the exp_num walking has a peculiar control flow but, once
+    // again, the "script/process-json-numbers.c with -p" benchmark is
+    // sensitive to alternative formulations.
+    if (wuffs_private_impl__is_decimal_digit_before(p, q)) {
+      exp_num = (10 * exp_num) + ((uint8_t)(*p - '0'));
+      p++;
+    }
+    if (wuffs_private_impl__is_decimal_digit_before(p, q)) {
+      exp_num = (10 * exp_num) + ((uint8_t)(*p - '0'));
+      p++;
+    }
+    while (wuffs_private_impl__is_decimal_digit_before(p, q)) {
+      if (exp_num > 0x1000000) {
+        return NULL;
+      }
+      exp_num = (10 * exp_num) + ((uint8_t)(*p - '0'));
+      p++;
+    }
+    exp10 += exp_sign * exp_num;
+  }
+
+  // Check that the uint64_t typed man variable has not overflowed, based on
+  // digit_count.
+  //
+  // For reference:
+  //   - (1 << 63) is  9223372036854775808, which has 19 decimal digits.
+  //   - (1 << 64) is 18446744073709551616, which has 20 decimal digits.
+  //   - 19 nines,  9999999999999999999, is  0x8AC7230489E7FFFF, which has 64
+  //     bits and 16 hexadecimal digits.
+  //   - 20 nines, 99999999999999999999, is 0x56BC75E2D630FFFFF, which has 67
+  //     bits and 17 hexadecimal digits.
+  if (digit_count > 19) {
+    // Even if we have more than 19 pseudo-digits, it's not yet definitely an
+    // overflow. Recall that digit_count might be off-by-one (too large) if
+    // there's a decimal separator. It will also over-report the number of
+    // meaningful digits if the input looks something like "0.000dddExxx".
+    //
+    // We adjust by the number of leading '0's and '.'s and re-compare to 19.
+    // Once again, technically, we could skip ','s too, but that perturbs the
+    // "script/process-json-numbers.c with -p" benchmark.
+    const uint8_t* r = start_of_digits_ptr;
+    for (; (r < p) && ((*r == '0') || (*r == '.')); r++) {
+    }
+    digit_count -= (uint32_t)(r - start_of_digits_ptr);
+    if (digit_count > 19) {
+      // We really have more than 19 significant digits and man has
+      // overflowed. Re-walk them, keeping only the first 19 in man and adding
+      // 1 to exp10 for every dropped digit. The caller can bracket the value
+      // with man and (man + 1), so that e.g. 17 to 25 digit inputs rarely
+      // need the (slow) fallback. If truncated, man is at least 1e18, so the
+      // caller's Clinger fast path (which needs an exact man) won't apply.
+      //
+      // The digits are [r .. sep) and, if there's a separator, (sep .. end).
+      const uint8_t* end = end_of_digits_ptr;
+      for (; (r < end) && ((*r == '0') || (*r == separator)); r++) {
+      }
+      // This is a bounded loop, not memchr, since GCC's -Wstringop-overread
+      // can otherwise derive an impossible bound from a caller's constants.
+      const uint8_t* sep = r;
+      for (; (sep < end) && (*sep != separator); sep++) {
+      }
+      uint32_t num_digits = (uint32_t)((end - r) - ((sep < end) ? 1 : 0));
+      if (num_digits > 0x1000000) {
+        return NULL;
+      }
+      size_t n0 = (size_t)(sep - r);
+      if (n0 > 19) {
+        n0 = 19;
+      }
+      size_t n1 = (sep < end) ? ((size_t)(end - (sep + 1))) : 0;
+      if (n1 > (19 - n0)) {
+        n1 = 19 - n0;
+      }
+      man = 0;
+      wuffs_private_impl__parse_number__scan_digits__portable(&man, r, r + n0,
+                                                              false);
+      bool truncated = !wuffs_private_impl__are_all_zero_digits(r + n0, sep);
+      if (sep < end) {
+        wuffs_private_impl__parse_number__scan_digits__portable(
+            &man, sep + 1, sep + 1 + n1, false);
+        truncated = truncated || !wuffs_private_impl__are_all_zero_digits(
+                                     sep + 1 + n1, end);
+      }
+      dst->man = man;
+      dst->exp10 = exp10 + ((int32_t)(num_digits - (n0 + n1)));
+      dst->negative = negative;
+      dst->truncated = truncated;
+      return p;
+    }
+  }
+
+  dst->man = man;
+  dst->exp10 = exp10;
+  dst->negative = negative;
+  dst->truncated = false;
+  return p;
+}
+
+// wuffs_private_impl__parse_number__scan_whole_man_exp10 is like
+// wuffs_private_impl__parse_number__scan_man_exp10 but returns whether all of
+// s (and not just a prefix) was consumed.
+//
+// With the ALLOW_UNDERSCORES option, the Wuffs grammar ignores every '_'.
+// Rather than teach the fast path's loops about them (which would slow down
+// the common, underscore-free case), copy a short input that has any
+// underscores to a stack buffer without them and scan that instead. Long
+// inputs, and anything else that the fast path doesn't handle, still go to
+// the caller's fallback, which re-parses the original s.
+static WUFFS_BASE__FORCE_INLINE bool  //
+wuffs_private_impl__parse_number__scan_whole_man_exp10(
+    wuffs_private_impl__man_exp10* dst,
+    wuffs_base__slice_u8 s,
+    uint32_t options,
+    bool padded) {
+  const uint8_t* p = s.ptr;
+  const uint8_t* q = s.ptr + s.len;
+  uint8_t buf[64];
+  if ((options & WUFFS_BASE__PARSE_NUMBER_XXX__ALLOW_UNDERSCORES) &&
+      (s.len > 0) && memchr(s.ptr, '_', s.len)) {
+    if (s.len > sizeof(buf)) {
+      return false;
+    }
+    size_t n = 0;
+    for (; p < q; p++) {
+      buf[n] = *p;
+      n += (*p != '_') ? 1 : 0;
+    }
+    p = &buf[0];
+    q = &buf[n];
+    padded = false;
+  }
+  const uint8_t* r =
+      wuffs_private_impl__parse_number__scan_man_exp10(dst, p, q, options,
+                                                       padded);
+  return r && (r == q);
+}
+
+// wuffs_private_impl__man_exp10__to_f64_fast converts x to the nearest f64,
+// using the Clinger fast path or the Eisel-Lemire algorithm. It returns false
+// (and leaves *dst alone) if neither applies, in which case the caller should
+// fall back to the slower but comprehensive algorithm.
+static inline bool  //
+wuffs_private_impl__man_exp10__to_f64_fast(
+    const wuffs_private_impl__man_exp10* x,
+    double* dst) {
+  uint64_t man = x->man;
+  int32_t exp10 = x->exp10;
+
+  // The wuffs_private_impl__parse_number_f64_eisel_lemire preconditions
+  // include that exp10 is in the range [-342 ..= 308].
+  if ((exp10 < -342) || (308 < exp10)) {
+    return false;
+  }
+
+  // If both man and (10 ** exp10) are exactly representable by a double, we
+  // don't need to run the Eisel-Lemire algorithm.
+  if ((-22 <= exp10) && (exp10 <= 22) && ((man >> 53) == 0)) {
+    double d = (double)man;
+    if (exp10 >= 0) {
+      d *= wuffs_private_impl__f64_powers_of_10[+exp10];
+    } else {
+      d /= wuffs_private_impl__f64_powers_of_10[-exp10];
+    }
+    *dst = x->negative ? -d : +d;
+    WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(clinger);
+    return true;
+  }
+
+  // The wuffs_private_impl__parse_number_f64_eisel_lemire preconditions
+  // include that man is non-zero. Parsing "0" should be caught by the "If
+  // both man and (10 ** exp10)" above, but "0e99" might not.
+  if (man == 0) {
+    return false;
+  }
+
+  // Our man and exp10 are in range. Run the Eisel-Lemire algorithm.
+  int64_t r = wuffs_private_impl__parse_number_f64_eisel_lemire(man, exp10);
+  if (r < 0) {
+    return false;
+  } else if (x->truncated) {
+    // Run it again for the upper bound. We still have an exact result (within
+    // f64's rounding margin) if both bounds are equal.
+    int64_t r1 =
+        wuffs_private_impl__parse_number_f64_eisel_lemire(man + 1, exp10);
+    if (r1 != r) {
+      return false;
+    }
+  }
+  *dst = wuffs_base__ieee_754_bit_representation__from_u64_to_f64(
+      ((uint64_t)r) | (((uint64_t)(x->negative)) << 63));
+  WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(eisel_lemire);
+  return true;
+}
+
+// wuffs_private_impl__parse_number__starts_like_a_number returns whether s,
+// after any leading underscores (if allowed) and an optional sign, starts
+// with a decimal digit or the decimal separator. If not, s can only be "inf",
+// "nan" (and their variants) or invalid, so there's no need to try parsing it
+// as a wuffs_private_impl__high_prec_dec.
+static inline bool  //
+wuffs_private_impl__parse_number__starts_like_a_number(wuffs_base__slice_u8 s,
+                                                       uint32_t options) {
+  const bool underscores =
+      options & WUFFS_BASE__PARSE_NUMBER_XXX__ALLOW_UNDERSCORES;
+  const uint8_t* p = s.ptr;
+  const uint8_t* q = s.ptr + s.len;
+  for (; underscores && (p < q) && (*p == '_'); p++) {
+  }
+  if ((p < q) && ((*p == '+') || (*p == '-'))) {
+    p++;
+  }
+  for (; underscores && (p < q) && (*p == '_'); p++) {
+  }
+  return (p < q) &&
+         (wuffs_private_impl__is_decimal_digit(*p) ||
+          (*p == ((options &
+                   WUFFS_BASE__PARSE_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA)
+                      ? ','
+                      : '.')));
+}
+
+// wuffs_private_impl__parse_number_f64_fallback is the slower but
+// comprehensive half of wuffs_private_impl__parse_number_f64__inline. It is a
+// separate (not inlined) function so that each specialization of the latter
+// only duplicates the fast path.
+static wuffs_base__result_f64  //
+wuffs_private_impl__parse_number_f64_fallback(wuffs_base__slice_u8 s,
+                                              uint32_t options) {
+  wuffs_private_impl__high_prec_dec h;
+  if (!wuffs_private_impl__parse_number__starts_like_a_number(s, options) ||
+      wuffs_private_impl__high_prec_dec__parse(&h, s, options).repr) {
+    WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(special);
+    return wuffs_private_impl__parse_number_f64_special(s, options);
+  }
+#if defined(WUFFS_CONFIG__ENABLE_PARSE_NUMBER_STATS)
+  wuffs_base__parse_number__stats* stats =
+      &wuffs_private_impl__parse_number__stats;
+  uint64_t num_sdc = stats->fallback_simple_decimal_conversion;
+  wuffs_base__result_f64 ret =
+      wuffs_private_impl__high_prec_dec__to_f64(&h, options);
+  if (num_sdc != stats->fallback_simple_decimal_conversion) {
+    size_t n = (s.len < sizeof(stats->last_slow_input))
+                   ? s.len
+                   : sizeof(stats->last_slow_input);
+    memcpy(stats->last_slow_input, s.ptr, n);
+    stats->last_slow_input_len = s.len;
+  }
+  return ret;
+#else
+  return wuffs_private_impl__high_prec_dec__to_f64(&h, options);
+#endif
+}
+
+// wuffs_private_impl__parse_number_f64__fast is the fast path shared by
+// wuffs_base__parse_number_f64 and its variants. It returns whether it set
+// *dst. If not, the caller should use the fallback instead.
+//
+// In practice, almost all "dd.ddddE±xxx" numbers can be represented
+// losslessly by a uint64_t mantissa "dddddd" and an int32_t base-10 exponent,
+// adjusting "xxx" for the position (if present) of the decimal separator '.'
+// or ','. See wuffs_private_impl__man_exp10.
+//
+// If s's number fits in a (man, exp10), parse that pair with the Eisel-Lemire
+// algorithm. If not, or if Eisel-Lemire fails, parsing s with the fallback
+// algorithm is slower but comprehensive.
+static WUFFS_BASE__FORCE_INLINE bool  //
+wuffs_private_impl__parse_number_f64__fast(wuffs_base__result_f64* dst,
+                                           wuffs_base__slice_u8 s,
+                                           uint32_t options,
+                                           bool padded) {
+  // The Wuffs API is that the original slice has no trailing data.
+  wuffs_private_impl__man_exp10 x;
+  if (!wuffs_private_impl__parse_number__scan_whole_man_exp10(&x, s, options,
+                                                              padded) ||
+      !wuffs_private_impl__man_exp10__to_f64_fast(&x, &dst->value)) {
+    return false;
+  }
+  dst->status.repr = NULL;
+  return true;
+}
+
+// wuffs_private_impl__parse_number_f64__inline implements
+// wuffs_base__parse_number_f64. It is forcibly inlined so that callers with a
+// compile-time constant options, such as those defined by the
+// WUFFS_BASE__DEFINE_PARSE_NUMBER_F64 macro, get a specialized fast path.
+static WUFFS_BASE__FORCE_INLINE wuffs_base__result_f64  //
+wuffs_private_impl__parse_number_f64__inline(wuffs_base__slice_u8 s,
+                                             uint32_t options) {
+  wuffs_base__result_f64 ret;
+  if (wuffs_private_impl__parse_number_f64__fast(&ret, s, options, false)) {
+    return ret;
+  }
+  return wuffs_private_impl__parse_number_f64_fallback(s, options);
+}
+
+static WUFFS_BASE__POTENTIALLY_UNUSED wuffs_base__result_f64  //
+wuffs_base__parse_number_f64(wuffs_base__slice_u8 s, uint32_t options) {
+  return wuffs_private_impl__parse_number_f64__inline(s, options);
+}
+
+// WUFFS_BASE__DEFINE_PARSE_NUMBER_F64 defines a function, called func_name,
+// that is equivalent to wuffs_base__parse_number_f64 with its options
+// argument fixed to the compile-time constant options_value. The option
+// checks in the fast path (such as which decimal separator to look for) then
+// fold away. For example:
+//
+//   WUFFS_BASE__DEFINE_PARSE_NUMBER_F64(
+//       parse_european_f64,
+//       WUFFS_BASE__PARSE_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA)
+//
+// defines "static wuffs_base__result_f64 parse_european_f64(
+// wuffs_base__slice_u8 s)". Each definition has its own copy of the fast path
+// but they all share the one fallback.
+#define WUFFS_BASE__DEFINE_PARSE_NUMBER_F64(func_name, options_value)      \
+  static wuffs_base__result_f64 func_name(wuffs_base__slice_u8 s) {        \
+    return wuffs_private_impl__parse_number_f64__inline(                   \
+        s, (uint32_t)(options_value));                                     \
+  }
+
+// wuffs_base__parse_number_f64_padded is like wuffs_base__parse_number_f64
+// except that it may read a little past the end of s. This lets the fast path
+// always load 8 bytes at a time, even for the last few digits of a run.
+//
+// Precondition: the WUFFS_BASE__PARSE_NUMBER_FXX__NUM_PADDING_BYTES bytes
+// starting at (s.ptr + s.len) are readable. Their values do not matter and do
+// not affect the result. For example, a slice of a larger buffer that holds
+// many numbers is fine (as long as the larger buffer is itself padded) and so
+// is a buffer allocated with simdjson-style padding.
+static WUFFS_BASE__POTENTIALLY_UNUSED wuffs_base__result_f64  //
+wuffs_base__parse_number_f64_padded(wuffs_base__slice_u8 s, uint32_t options) {
+  wuffs_base__result_f64 ret;
+  if (wuffs_private_impl__parse_number_f64__fast(&ret, s, options, true)) {
+    return ret;
+  }
+  return wuffs_private_impl__parse_number_f64_fallback(s, options);
+}
+
+// --------
+
+// wuffs_base__parse_number__default_null_sentinels lists commonly used
+// markers for missing values in CSV and similar text formats. They are
+// matched exactly (case-sensitively, without trimming whitespace).
+static const wuffs_base__slice_u8
+    wuffs_base__parse_number__default_null_sentinels[] = {
+        {(uint8_t*)"", 0},      {(uint8_t*)"-", 1},
+        {(uint8_t*)"NA", 2},    {(uint8_t*)"N/A", 3},
+        {(uint8_t*)"null", 4},  {(uint8_t*)"NULL", 4},
+        {(uint8_t*)"None", 4},  {(uint8_t*)"#N/A", 4},
+};
+
+#define WUFFS_BASE__PARSE_NUMBER__NUM_DEFAULT_NULL_SENTINELS 8
+
+// wuffs_base__try_parse_number_f64 is like wuffs_base__parse_number_f64 but
+// separates missing values from malformed ones. If s does not look like a
+// number (see below) and is exactly equal to one of the null_sentinels, the
+// status is the wuffs_base__note__null_value note (so that
+// wuffs_base__status__is_error returns false) and the value is zero.
+//
+// Numbers take priority over sentinels. s "looks like a number" if, after
+// any leading underscores (if allowed) and an optional sign, it starts with a
+// decimal digit or the decimal separator. Only inputs that don't look like a
+// number are compared against the sentinels, so that the common case (a
+// valid number) costs the same as wuffs_base__parse_number_f64 and the
+// missing-value case costs one classification and a few memcmp calls, without
+// the slow path's full re-parse.
+//
+// null_sentinels may be NULL if num_null_sentinels is zero. Pass
+// wuffs_base__parse_number__default_null_sentinels and
+// WUFFS_BASE__PARSE_NUMBER__NUM_DEFAULT_NULL_SENTINELS for a reasonable
+// default set.
+static WUFFS_BASE__POTENTIALLY_UNUSED wuffs_base__result_f64  //
+wuffs_base__try_parse_number_f64(wuffs_base__slice_u8 s,
+                                 uint32_t options,
+                                 const wuffs_base__slice_u8* null_sentinels,
+                                 size_t num_null_sentinels) {
+  wuffs_base__result_f64 ret;
+  if (wuffs_private_impl__parse_number_f64__fast(&ret, s, options, false)) {
+    return ret;
+  } else if (wuffs_private_impl__parse_number__starts_like_a_number(s,
+                                                                    options)) {
+    return wuffs_private_impl__parse_number_f64_fallback(s, options);
+  }
+
+  size_t i;
+  for (i = 0; i < num_null_sentinels; i++) {
+    if ((null_sentinels[i].len == s.len) &&
+        ((s.len == 0) || !memcmp(null_sentinels[i].ptr, s.ptr, s.len))) {
+      ret.status.repr = wuffs_base__note__null_value;
+      ret.value = 0;
+      return ret;
+    }
+  }
+  WUFFS_PRIVATE_IMPL__PARSE_NUMBER_STATS__INC(special);
+  return wuffs_private_impl__parse_number_f64_special(s, options);
+}
+
+// --------
+
+// wuffs_base__parse_number_f64_prefix__output is the result of
+// wuffs_base__parse_number_f64_prefix. On success, num_bytes is the length of
+// the number that was parsed (and is always positive). On failure, num_bytes
+// and value are zero.
+typedef struct wuffs_base__parse_number_f64_prefix__output__struct {
+  wuffs_base__status status;
+  double value;
+  size_t num_bytes;
+} wuffs_base__parse_number_f64_prefix__output;
+
+// wuffs_private_impl__parse_number_f64_prefix_length returns the length of
+// the longest prefix of s that looks like a number (including "inf" and "nan"
+// variants) under the given options. It is conservative in that the prefix
+// may still fail to parse (e.g. "." or ".0") but, if any non-empty prefix of s
+// is a valid number, then it is the one whose length is returned.
+static size_t  //
+wuffs_private_impl__parse_number_f64_prefix_length(wuffs_base__slice_u8 s,
+                                                   uint32_t options) {
+  const bool underscores =
+      options & WUFFS_BASE__PARSE_NUMBER_XXX__ALLOW_UNDERSCORES;
+  const uint8_t separator =
+      (options & WUFFS_BASE__PARSE_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA)
+          ? ','
+          : '.';
+  const uint8_t* p = s.ptr;
+  const uint8_t* q = s.ptr + s.len;
+
+  // Skip any leading underscores, the sign and any underscores after that.
+  // Like wuffs_private_impl__parse_number_f64_special, "inf" and "nan"
+  // allow those underscores regardless of the ALLOW_UNDERSCORES option.
+  bool saw_underscores = false;
+  for (; (p < q) && (*p == '_'); p++) {
+    saw_underscores = true;
+  }
+  if ((p < q) && ((*p == '+') || (*p == '-'))) {
+    p++;
+  }
+  for (; (p < q) && (*p == '_'); p++) {
+    saw_underscores = true;
+  }
+  if (p >= q) {
+    return 0;
+  }
+
+  // Look for "inf", "infinity" or "nan", case-insensitively.
+  if (((*p | 0x20) == 'i') || ((*p | 0x20) == 'n')) {
+    static const char infinity[8] = {'i', 'n', 'f', 'i', 'n', 'i', 't', 'y'};
+    const char* word = ((*p | 0x20) == 'i') ? &infinity[0] : "nan";
+    size_t n = 0;
+    for (; (n < 8) && ((p + n) < q) && ((p[n] | 0x20) == word[n]); n++) {
+    }
+    if ((word == &infinity[0]) && (n == 8)) {
+      p += 8;
+    } else if (n >= 3) {
+      p += 3;
+    } else {
+      return 0;
+    }
+    for (; (p < q) && (*p == '_'); p++) {
+    }
+    return (size_t)(p - s.ptr);
+  } else if (saw_underscores && !underscores) {
+    return 0;
+  }
+
+  // Walk the digits before and after the optional decimal separator. Without
+  // the ALLOW_MULTIPLE_LEADING_ZEROES option, a leading '0' stands alone.
+  bool saw_digits = false;
+  if ((*p == '0') &&
+      !(options &
+        WUFFS_BASE__PARSE_NUMBER_XXX__ALLOW_MULTIPLE_LEADING_ZEROES)) {
+    saw_digits = true;
+    for (p++; underscores && (p < q) && (*p == '_'); p++) {
+    }
+  } else {
+    for (; (p < q) && (wuffs_private_impl__is_decimal_digit(*p) ||
+                       (underscores && (*p == '_')));
+         p++) {
+      saw_digits = saw_digits || (*p != '_');
+    }
+  }
+  if ((p < q) && (*p == separator)) {
+    for (p++; (p < q) && (wuffs_private_impl__is_decimal_digit(*p) ||
+                          (underscores && (*p == '_')));
+         p++) {
+      saw_digits = saw_digits || (*p != '_');
+    }
+  }
+  if (!saw_digits) {
+    return 0;
+  }
+
+  // The exponent is only part of the number if it has at least one digit.
+  if ((p < q) && ((*p | 0x20) == 'e')) {
+    const uint8_t* e = p + 1;
+    for (; underscores && (e < q) && (*e == '_'); e++) {
+    }
+    if ((e < q) && ((*e == '+') || (*e == '-'))) {
+      e++;
+    }
+    bool saw_exp_digits = false;
+    for (; (e < q) && (wuffs_private_impl__is_decimal_digit(*e) ||
+                       (underscores && (*e == '_')));
+         e++) {
+      saw_exp_digits = saw_exp_digits || (*e != '_');
+    }
+    if (saw_exp_digits) {
+      p = e;
+    }
+  }
+  return (size_t)(p - s.ptr);
+}
+
+// wuffs_base__parse_number_f64_prefix is like wuffs_base__parse_number_f64
+// except that s may have trailing data. It parses the longest prefix of s
+// that is a number and reports that prefix's length, similar to C++'s
+// std::from_chars. For example, parsing "12.5e3,7" gives 12500 and a num_bytes
+// of 6, and parsing "1e+x" gives 1 and a num_bytes of 1.
+//
+// This lets a tokenizer find the end of a number and convert it in the same
+// pass over the bytes, instead of finding the end first and then converting.
+static WUFFS_BASE__POTENTIALLY_UNUSED
+wuffs_base__parse_number_f64_prefix__output  //
+wuffs_base__parse_number_f64_prefix(wuffs_base__slice_u8 s, uint32_t options) {
+  wuffs_base__parse_number_f64_prefix__output ret;
+  do {
+    const uint8_t* q = s.ptr + s.len;
+    wuffs_private_impl__man_exp10 x;
+    const uint8_t* p = wuffs_private_impl__parse_number__scan_man_exp10(
+        &x, s.ptr, q, options, false);
+    if (!p) {
+      break;
+    }
+
+    // Bytes that could have continued the number (in the full grammar, not
+    // just the fast path's subset) mean that the fast path stopped too early.
+    if ((p < q) &&
+        ((*p == ((options &
+                  WUFFS_BASE__PARSE_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA)
+                     ? ','
+                     : '.')) ||
+         ((*p | 0x20) == 'e') ||
+         ((*p == '_') &&
+          (options & WUFFS_BASE__PARSE_NUMBER_XXX__ALLOW_UNDERSCORES)))) {
+      break;
+    }
+
+    if (!wuffs_private_impl__man_exp10__to_f64_fast(&x, &ret.value)) {
+      break;
+    }
+    ret.status.repr = NULL;
+    ret.num_bytes = (size_t)(p - s.ptr);
+    return ret;
+  } while (0);
+
+  size_t n = wuffs_private_impl__parse_number_f64_prefix_length(s, options);
+  if (n > 0) {
+    s.len = n;
+    wuffs_base__result_f64 r = wuffs_base__parse_number_f64(s, options);
+    if (!r.status.repr) {
+      ret.status.repr = NULL;
+      ret.value = r.value;
+      ret.num_bytes = n;
+      return ret;
+    }
+  }
+  ret.status.repr = wuffs_base__error__bad_argument;
+  ret.value = 0;
+  ret.num_bytes = 0;
+  return ret;
+}
+
+static WUFFS_BASE__FORCE_INLINE size_t  //
+wuffs_private_impl__parse_number_f64_batch__inline(
+    double* dst,
+    uint8_t* dst_error_bitmap,
+    const wuffs_base__slice_u8* src,
+    size_t n,
+    uint32_t options) {
+  size_t num_errors = 0;
+  size_t i = 0;
+  while (i < n) {
+    size_t j_max = ((n - i) < 8) ? (n - i) : 8;
+    uint8_t error_bits = 0;
+    size_t j;
+    for (j = 0; j < j_max; j++) {
+      wuffs_base__result_f64 r =
+          wuffs_private_impl__parse_number_f64__inline(src[i + j], options);
+      dst[i + j] = r.value;
+      if (r.status.repr) {
+        error_bits |= (uint8_t)(1u << j);
+        num_errors++;
+      }
+    }
+    if (dst_error_bitmap) {
+      dst_error_bitmap[i >> 3] = error_bits;
+    }
+    i += j_max;
+  }
+  return num_errors;
+}
+
+// wuffs_base__parse_number_f64_batch parses src[i] into dst[i] for each i in
+// [0 .. n), with the same semantics (and the same options) as
+// wuffs_base__parse_number_f64.
+//
+// Errors are reported in dst_error_bitmap, if non-NULL, which must have room
+// for at least ((n + 7) / 8) bytes. Bit (i & 7) of dst_error_bitmap[i >> 3] is
+// set if and only if src[i] failed to parse, in which case dst[i] is zero.
+// Any unused high bits of the final byte are cleared.
+//
+// It returns the number of failed elements, so that a zero return value means
+// that there is no need to look at dst_error_bitmap at all.
+//
+// Calling this once (instead of calling wuffs_base__parse_number_f64 n times)
+// keeps the fast path's code and look-up tables hot and gives the compiler
+// freedom to interleave the work of independent elements.
+//
+// The options are checked once per call, not once per element: the default
+// options get their own specialized loop.
+static WUFFS_BASE__POTENTIALLY_UNUSED size_t  //
+wuffs_base__parse_number_f64_batch(double* dst,
+                                   uint8_t* dst_error_bitmap,
+                                   const wuffs_base__slice_u8* src,
+                                   size_t n,
+                                   uint32_t options) {
+  if (options == WUFFS_BASE__PARSE_NUMBER_XXX__DEFAULT_OPTIONS) {
+    return wuffs_private_impl__parse_number_f64_batch__inline(
+        dst, dst_error_bitmap, src, n,
+        WUFFS_BASE__PARSE_NUMBER_XXX__DEFAULT_OPTIONS);
+  }
+  return wuffs_private_impl__parse_number_f64_batch__inline(
+      dst, dst_error_bitmap, src, n, options);
+}
+
+// --------
+
+// wuffs_base__f64_from_man_exp10 returns the f64 value nearest to (man * (10
+// ** exp10)), negated if negative is true. Like wuffs_base__parse_number_f64,
+// it is correctly rounded (ties to even), overflows to infinity and
+// underflows to zero, but it starts from an already-decoded mantissa and
+// base-10 exponent (such as a SQL, Arrow or Parquet DECIMAL value with its
+// scale negated) instead of from text.
+//
+// It uses the Clinger fast path or the Eisel-Lemire algorithm when they
+// apply and the same fallback as parsing (big integer digit comparison, then
+// Simple Decimal Conversion) when they don't.
+static WUFFS_BASE__POTENTIALLY_UNUSED double  //
+wuffs_base__f64_from_man_exp10(uint64_t man, int32_t exp10, bool negative) {
+  wuffs_private_impl__man_exp10 x;
+  x.man = man;
+  x.exp10 = exp10;
+  x.negative = negative;
+  x.truncated = false;
+  double d;
+  if (wuffs_private_impl__man_exp10__to_f64_fast(&x, &d)) {
+    return d;
+  } else if (man == 0) {
+    return negative ? -0.0 : +0.0;
+  }
+
+  // Clamp exp10 so that adding it to h.decimal_point can't overflow. Any
+  // decimal_point outside of [-326 ..= 310] is an obvious zero or infinity
+  // to wuffs_private_impl__high_prec_dec__to_f64.
+  if (exp10 < -WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE) {
+    exp10 = -WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE;
+  } else if (exp10 > +WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE) {
+    exp10 = +WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE;
+  }
+  wuffs_private_impl__high_prec_dec h;
+  wuffs_private_impl__high_prec_dec__assign(&h, man, negative);
+  h.decimal_point += exp10;
+  return wuffs_private_impl__high_prec_dec__to_f64(&h, 0).value;
+}
+
+// wuffs_base__f64_from_man_exp10__batch sets dst[i] to
+// wuffs_base__f64_from_man_exp10(abs(src_man[i]), exp10, src_man[i] < 0) for
+// each i in [0 .. n). All of the elements share the one exp10, as they do in
+// a fixed-scale DECIMAL column.
+//
+// When exp10 is in [-22 ..= +22], (10 ** exp10) is an exactly representable
+// f64, and so is every mantissa below (1 << 53), in which case one correctly
+// rounded multiplication or division per element gives the answer (the
+// Clinger fast path). This function checks that condition once per block of
+// 8 elements, so that such blocks run as a branch-free loop that compilers
+// can vectorize. Other elements take the per-element path.
+static WUFFS_BASE__POTENTIALLY_UNUSED void  //
+wuffs_base__f64_from_man_exp10__batch(double* dst,
+                                      const int64_t* src_man,
+                                      size_t n,
+                                      int32_t exp10) {
+  const bool clinger = (-22 <= exp10) && (exp10 <= +22);
+  const double po10 =
+      wuffs_private_impl__f64_powers_of_10[clinger ? ((exp10 >= 0) ? +exp10
+                                                                   : -exp10)
+                                                   : 0];
+  const bool divide = exp10 < 0;
+
+  size_t i = 0;
+  if (clinger) {
+    for (; (n - i) >= 8; i += 8) {
+      // Each ((m + (1 << 53)) >> 54) is zero if and only if m is in the
+      // range [-(1 << 53) .. (1 << 53)). Those m are exactly representable.
+      uint64_t big = 0;
+      size_t j;
+      for (j = 0; j < 8; j++) {
+        big |= (((uint64_t)(src_man[i + j])) + 0x0020000000000000) >> 54;
+      }
+      if (big) {
+        for (j = 0; j < 8; j++) {
+          int64_t m = src_man[i + j];
+          dst[i + j] = wuffs_base__f64_from_man_exp10(
+              (m < 0) ? (0 - (uint64_t)m) : (uint64_t)m, exp10, m < 0);
+        }
+      } else if (divide) {
+        for (j = 0; j < 8; j++) {
+          dst[i + j] = ((double)(src_man[i + j])) / po10;
+        }
+      } else {
+        for (j = 0; j < 8; j++) {
+          dst[i + j] = ((double)(src_man[i + j])) * po10;
+        }
+      }
+    }
+  }
+
+  for (; i < n; i++) {
+    int64_t m = src_man[i];
+    dst[i] = wuffs_base__f64_from_man_exp10(
+        (m < 0) ? (0 - (uint64_t)m) : (uint64_t)m, exp10, m < 0);
+  }
+}
+
+// --------
+
+// wuffs_base__count_number_lines returns how many values
+// wuffs_base__parse_number_f64_lines would write for src (given a large
+// enough dst): the number of non-empty lines. It lets a caller size dst
+// before parsing.
+static WUFFS_BASE__POTENTIALLY_UNUSED size_t  //
+wuffs_base__count_number_lines(wuffs_base__slice_u8 src) {
+  size_t n = 0;
+  const uint8_t* p = src.ptr;
+  const uint8_t* const q = src.ptr + src.len;
+  while (p < q) {
+    const uint8_t* eol = (const uint8_t*)memchr(p, '\n', (size_t)(q - p));
+    if (!eol) {
+      eol = q;
+    }
+    const uint8_t* end = ((eol > p) && (eol[-1] == '\r')) ? (eol - 1) : eol;
+    n += (end > p) ? 1 : 0;
+    p = (eol < q) ? (eol + 1) : q;
+  }
+  return n;
+}
+
+// wuffs_base__parse_number_f64_lines__output is the result of
+// wuffs_base__parse_number_f64_lines.
+typedef struct wuffs_base__parse_number_f64_lines__output__struct {
+  // num_values is how many elements of dst were written.
+  size_t num_values;
+  // num_errors is how many of those were lines that failed to parse (and
+  // were written as zero, like wuffs_base__parse_number_f64_batch does).
+  size_t num_errors;
+  // num_bytes is how many bytes of src were consumed. It is less than
+  // src.len only if dst filled up first, in which case the caller can resume
+  // from (src.ptr + num_bytes).
+  size_t num_bytes;
+} wuffs_base__parse_number_f64_lines__output;
+
+// wuffs_base__parse_number_f64_lines parses src, a buffer of
+// newline-delimited numbers (such as a memory-mapped file), into dst. Each
+// line is parsed in place, as a sub-slice of src, without copying. A "\r"
+// before a "\n" is ignored, as are empty lines (including after a final
+// "\n"). The end of src also ends the last line.
+//
+// Lines far enough from the end of src are parsed with
+// wuffs_base__parse_number_f64_padded, since the bytes after them (the rest
+// of src) are readable.
+static WUFFS_BASE__POTENTIALLY_UNUSED
+wuffs_base__parse_number_f64_lines__output  //
+wuffs_base__parse_number_f64_lines(double* dst,
+                                   size_t dst_len,
+                                   wuffs_base__slice_u8 src,
+                                   uint32_t options) {
+  wuffs_base__parse_number_f64_lines__output ret;
+  ret.num_values = 0;
+  ret.num_errors = 0;
+
+  uint8_t* p = src.ptr;
+  uint8_t* const q = src.ptr + src.len;
+  uint8_t* const padded_q =
+      (src.len > WUFFS_BASE__PARSE_NUMBER_FXX__NUM_PADDING_BYTES)
+          ? (q - WUFFS_BASE__PARSE_NUMBER_FXX__NUM_PADDING_BYTES)
+          : src.ptr;
+  while ((p < q) && (ret.num_values < dst_len)) {
+    uint8_t* eol = (uint8_t*)memchr(p, '\n', (size_t)(q - p));
+    uint8_t* next = eol ? (eol + 1) : q;
+    if (!eol) {
+      eol = q;
+    }
+    uint8_t* end = ((eol > p) && (eol[-1] == '\r')) ? (eol - 1) : eol;
+
+    if (end > p) {
+      wuffs_base__slice_u8 s;
+      s.ptr = p;
+      s.len = (size_t)(end - p);
+      wuffs_base__result_f64 r =
+          (end <= padded_q) ? wuffs_base__parse_number_f64_padded(s, options)
+                            : wuffs_base__parse_number_f64(s, options);
+      dst[ret.num_values++] = r.value;
+      ret.num_errors += r.status.repr ? 1 : 0;
+    }
+    p = next;
+  }
+
+  ret.num_bytes = (size_t)(p - src.ptr);
+  return ret;
+}
+
+// --------
+
+// wuffs_base__parse_number_f64_stream is the state of a resumable parser for
+// a stream of delimited numbers that arrives in chunks, such as network
+// packets or fixed-size file reads, where one number can straddle two (or
+// more) chunks. Instead of copying such a number's bytes to a scratch buffer
+// and re-parsing them once the next chunk arrives, the parser carries its
+// partial result (the mantissa, exponents, digit count and where it is in the
+// number's grammar) from one chunk to the next. Each byte is visited once.
+//
+// Numbers are separated by one or more delimiters: ' ', '\t', '\n', '\r', ';'
+// and (unless the decimal separator is a comma) ','. Each number is parsed
+// like wuffs_base__parse_number_f64 with the same options, except that the
+// "inf" and "nan" literals are rejected.
+//
+// The (large) digits buffer is only used by numbers with more than 19
+// significant digits, which need it to be correctly rounded.
+//
+// Call wuffs_base__parse_number_f64_stream__initialize before any other
+// wuffs_base__parse_number_f64_stream__etc function. The fields are private.
+typedef struct wuffs_base__parse_number_f64_stream__struct {
+  struct {
+    uint32_t options;
+    uint32_t phase;
+    bool negative;
+    bool exp_negative;
+    // leading_zero is whether the integral digits so far are exactly "0".
+    bool leading_zero;
+    // saw_integral_digits is whether there are any digits (even zeroes)
+    // before the decimal separator.
+    bool saw_integral_digits;
+    // num_sig_digits counts the significant mantissa digits, up to 20. man
+    // holds the first 19 of them. The number's value is approximately (man *
+    // (10 ** (exp10 ± exp_num))), exactly so if num_sig_digits <= 19.
+    uint32_t num_sig_digits;
+    uint64_t man;
+    int32_t exp10;
+    int32_t exp_num;
+    // h holds all of the significant digits (up to its precision) when
+    // num_sig_digits > 19. Its decimal_point is set only when converting.
+    wuffs_private_impl__high_prec_dec h;
+  } private_impl;
+} wuffs_base__parse_number_f64_stream;
+
+#define WUFFS_PRIVATE_IMPL__STREAM__PHASE__BETWEEN 0
+#define WUFFS_PRIVATE_IMPL__STREAM__PHASE__START 1
+#define WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_SIGN 2
+#define WUFFS_PRIVATE_IMPL__STREAM__PHASE__INTEGRAL 3
+#define WUFFS_PRIVATE_IMPL__STREAM__PHASE__FRACTIONAL 4
+#define WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_E 5
+#define WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_EXP_SIGN 6
+#define WUFFS_PRIVATE_IMPL__STREAM__PHASE__EXPONENT 7
+#define WUFFS_PRIVATE_IMPL__STREAM__PHASE__INVALID 8
+
+// wuffs_base__parse_number_f64_stream__output is the result of
+// wuffs_base__parse_number_f64_stream__write and
+// wuffs_base__parse_number_f64_stream__finish.
+typedef struct wuffs_base__parse_number_f64_stream__output__struct {
+  // num_values is how many elements of dst were written.
+  size_t num_values;
+  // num_errors is how many of those were invalid numbers (written as zero).
+  size_t num_errors;
+  // num_bytes is how many bytes of src were consumed. It is less than
+  // src.len only if dst filled up first, in which case the caller should
+  // pass (src.ptr + num_bytes) again, with more room in dst.
+  size_t num_bytes;
+} wuffs_base__parse_number_f64_stream__output;
+
+static inline void  //
+wuffs_base__parse_number_f64_stream__initialize(
+    wuffs_base__parse_number_f64_stream* self,
+    uint32_t options) {
+  self->private_impl.options = options;
+  self->private_impl.phase = WUFFS_PRIVATE_IMPL__STREAM__PHASE__BETWEEN;
+}
+
+static inline bool  //
+wuffs_private_impl__parse_number_f64_stream__is_delimiter(uint8_t c,
+                                                          uint32_t options) {
+  switch (c) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case ';':
+      return true;
+    case ',':
+      return !(options &
+               WUFFS_BASE__PARSE_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA);
+  }
+  return false;
+}
+
+// wuffs_private_impl__parse_number_f64_stream__digit accumulates the mantissa
+// digit d, which is before the decimal separator if integral is true.
+static inline void  //
+wuffs_private_impl__parse_number_f64_stream__digit(
+    wuffs_base__parse_number_f64_stream* self,
+    uint8_t d,
+    bool integral) {
+  self->private_impl.saw_integral_digits |= integral;
+  if (self->private_impl.num_sig_digits == 0) {
+    // Leading zeroes aren't significant, but they do move a fractional
+    // number's decimal point. Clamp exp10 so that an absurd number of them
+    // can't overflow it (the value is zero either way).
+    if (d == 0) {
+      if (!integral && (self->private_impl.exp10 > -0x1000000)) {
+        self->private_impl.exp10--;
+      }
+      return;
+    }
+  } else if (self->private_impl.num_sig_digits >= 19) {
+    // man is full. Track the rest of the digits in h.
+    wuffs_private_impl__high_prec_dec* h = &self->private_impl.h;
+    if (self->private_impl.num_sig_digits == 19) {
+      self->private_impl.num_sig_digits = 20;
+      uint64_t m = self->private_impl.man;
+      int i;
+      for (i = 18; i >= 0; i--) {
+        h->digits[i] = (uint8_t)(m % 10);
+        m /= 10;
+      }
+      h->num_digits = 19;
+      h->truncated = false;
+    }
+    if (h->num_digits < WUFFS_PRIVATE_IMPL__HPD__DIGITS_PRECISION) {
+      h->digits[h->num_digits++] = d;
+    } else if (d > 0) {
+      h->truncated = true;
+    }
+    if (integral && (self->private_impl.exp10 < +0x1000000)) {
+      self->private_impl.exp10++;
+    }
+    return;
+  }
+  self->private_impl.num_sig_digits++;
+  self->private_impl.man = (10 * self->private_impl.man) + d;
+  if (!integral) {
+    self->private_impl.exp10--;
+  }
+}
+
+// wuffs_private_impl__parse_number_f64_stream__end_number converts the
+// number that has just ended (at a delimiter or at the end of the stream).
+static wuffs_base__result_f64  //
+wuffs_private_impl__parse_number_f64_stream__end_number(
+    wuffs_base__parse_number_f64_stream* self) {
+  wuffs_base__result_f64 ret;
+  bool valid = false;
+  switch (self->private_impl.phase) {
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__INTEGRAL:
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__FRACTIONAL:
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__EXPONENT:
+      // Like wuffs_base__parse_number_f64, reject ".", ".e5" and also ".0"
+      // (but not "0." or ".5").
+      valid = self->private_impl.saw_integral_digits ||
+              (self->private_impl.num_sig_digits > 0);
+      break;
+  }
+  self->private_impl.phase = WUFFS_PRIVATE_IMPL__STREAM__PHASE__BETWEEN;
+  if (!valid) {
+    ret.status.repr = wuffs_base__error__bad_argument;
+    ret.value = 0;
+    return ret;
+  }
+
+  // exp10 and exp_num are both clamped to ±0x1000000, so this can't overflow.
+  int32_t exp10 = self->private_impl.exp_negative
+                      ? (self->private_impl.exp10 - self->private_impl.exp_num)
+                      : (self->private_impl.exp10 + self->private_impl.exp_num);
+  bool truncated = self->private_impl.num_sig_digits > 19;
+
+  wuffs_private_impl__man_exp10 x;
+  x.man = self->private_impl.man;
+  x.exp10 = exp10;
+  x.negative = self->private_impl.negative;
+  x.truncated = truncated;
+  if (wuffs_private_impl__man_exp10__to_f64_fast(&x, &ret.value)) {
+    ret.status.repr = NULL;
+    return ret;
+  }
+
+  // Clamp exp10 as per wuffs_base__f64_from_man_exp10.
+  if (exp10 < -WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE) {
+    exp10 = -WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE;
+  } else if (exp10 > +WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE) {
+    exp10 = +WUFFS_PRIVATE_IMPL__HPD__DECIMAL_POINT__RANGE;
+  }
+  wuffs_private_impl__high_prec_dec* h = &self->private_impl.h;
+  if (truncated) {
+    // h->digits' first 19 digits are man's, so the decimal point is 19
+    // digits along from the (man * (10 ** exp10)) decimal point.
+    h->decimal_point = 19 + exp10;
+    h->negative = self->private_impl.negative;
+    wuffs_private_impl__high_prec_dec__trim(h);
+  } else {
+    wuffs_private_impl__high_prec_dec__assign(h, self->private_impl.man,
+                                              self->private_impl.negative);
+    h->decimal_point += exp10;
+  }
+  ret =
+      wuffs_private_impl__high_prec_dec__to_f64(h, self->private_impl.options);
+  if (ret.status.repr) {
+    ret.value = 0;
+  }
+  return ret;
+}
+
+// wuffs_private_impl__parse_number_f64_stream__byte advances self's state
+// machine by one byte, c, of a number (not a delimiter).
+static inline void  //
+wuffs_private_impl__parse_number_f64_stream__byte(
+    wuffs_base__parse_number_f64_stream* self,
+    uint8_t c) {
+  const uint32_t options = self->private_impl.options;
+  if ((c == '_') &&
+      (options & WUFFS_BASE__PARSE_NUMBER_XXX__ALLOW_UNDERSCORES)) {
+    return;
+  }
+  const uint8_t separator =
+      (options & WUFFS_BASE__PARSE_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA)
+          ? ','
+          : '.';
+  const bool digit = wuffs_private_impl__is_decimal_digit(c);
+  const uint8_t d = (uint8_t)(c - '0');
+
+  switch (self->private_impl.phase) {
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__START:
+      if ((c == '+') || (c == '-')) {
+        self->private_impl.negative = c == '-';
+        self->private_impl.phase =
+            WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_SIGN;
+        return;
+      }
+      // Fall through.
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_SIGN:
+      if (digit) {
+        self->private_impl.leading_zero = d == 0;
+        wuffs_private_impl__parse_number_f64_stream__digit(self, d, true);
+        self->private_impl.phase = WUFFS_PRIVATE_IMPL__STREAM__PHASE__INTEGRAL;
+        return;
+      } else if (c == separator) {
+        self->private_impl.phase =
+            WUFFS_PRIVATE_IMPL__STREAM__PHASE__FRACTIONAL;
+        return;
+      }
+      break;
+
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__INTEGRAL:
+      if (digit) {
+        if (self->private_impl.leading_zero &&
+            !(options &
+              WUFFS_BASE__PARSE_NUMBER_XXX__ALLOW_MULTIPLE_LEADING_ZEROES)) {
+          break;
+        }
+        wuffs_private_impl__parse_number_f64_stream__digit(self, d, true);
+        return;
+      } else if (c == separator) {
+        self->private_impl.phase =
+            WUFFS_PRIVATE_IMPL__STREAM__PHASE__FRACTIONAL;
+        return;
+      } else if ((c | 0x20) == 'e') {
+        self->private_impl.phase = WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_E;
+        return;
+      }
+      break;
+
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__FRACTIONAL:
+      if (digit) {
+        wuffs_private_impl__parse_number_f64_stream__digit(self, d, false);
+        return;
+      } else if ((c | 0x20) == 'e') {
+        self->private_impl.phase = WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_E;
+        return;
+      }
+      break;
+
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_E:
+      if ((c == '+') || (c == '-')) {
+        self->private_impl.exp_negative = c == '-';
+        self->private_impl.phase =
+            WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_EXP_SIGN;
+        return;
+      }
+      // Fall through.
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__AFTER_EXP_SIGN:
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__EXPONENT:
+      if (digit) {
+        if (self->private_impl.exp_num < 0x1000000) {
+          self->private_impl.exp_num = (10 * self->private_impl.exp_num) + d;
+        }
+        self->private_impl.phase = WUFFS_PRIVATE_IMPL__STREAM__PHASE__EXPONENT;
+        return;
+      }
+      break;
+
+    case WUFFS_PRIVATE_IMPL__STREAM__PHASE__INVALID:
+      return;
+  }
+  self->private_impl.phase = WUFFS_PRIVATE_IMPL__STREAM__PHASE__INVALID;
+}
+
+// wuffs_private_impl__parse_number_f64_stream__emit writes r to dst[i].
+static inline void  //
+wuffs_private_impl__parse_number_f64_stream__emit(
+    wuffs_base__parse_number_f64_stream__output* o,
+    double* dst,
+    uint8_t* dst_error_bitmap,
+    wuffs_base__result_f64 r) {
+  size_t i = o->num_values++;
+  dst[i] = r.value;
+  if (dst_error_bitmap) {
+    if ((i & 7) == 0) {
+      dst_error_bitmap[i >> 3] = 0;
+    }
+    if (r.status.repr) {
+      dst_error_bitmap[i >> 3] |= (uint8_t)(1u << (i & 7));
+    }
+  }
+  o->num_errors += r.status.repr ? 1 : 0;
+}
+
+// wuffs_base__parse_number_f64_stream__write parses the next chunk of the
+// stream, src, writing each number to dst as soon as its terminating
+// delimiter is seen. A number that is still going at the end of src is
+// continued by the next call (or ended by
+// wuffs_base__parse_number_f64_stream__finish).
+//
+// Errors are reported as per wuffs_base__parse_number_f64_batch: if
+// dst_error_bitmap is non-NULL, bit (i & 7) of dst_error_bitmap[i >> 3] is set
+// if and only if dst[i] (which is zero) was an invalid number, for each i in
+// [0 .. num_values). It needs room for ((dst_len + 7) / 8) bytes. Indexes are
+// relative to this call's dst, not to the start of the stream.
+//
+// Numbers that are entirely within src, before its last delimiter, don't need
+// the state machine. They're parsed in place with
+// wuffs_base__parse_number_f64_prefix, which is faster.
+static WUFFS_BASE__POTENTIALLY_UNUSED
+wuffs_base__parse_number_f64_stream__output  //
+wuffs_base__parse_number_f64_stream__write(
+    wuffs_base__parse_number_f64_stream* self,
+    double* dst,
+    uint8_t* dst_error_bitmap,
+    size_t dst_len,
+    wuffs_base__slice_u8 src) {
+  wuffs_base__parse_number_f64_stream__output ret;
+  ret.num_values = 0;
+  ret.num_errors = 0;
+
+  const uint32_t options = self->private_impl.options;
+  const uint8_t* p = src.ptr;
+  const uint8_t* const q = src.ptr + src.len;
+
+  // Find the last delimiter (or src.ptr if there isn't one). Every number
+  // that starts before it also ends before it, or at it.
+  const uint8_t* last_delimiter = q;
+  for (; last_delimiter > p; last_delimiter--) {
+    if (wuffs_private_impl__parse_number_f64_stream__is_delimiter(
+            last_delimiter[-1], options)) {
+      last_delimiter--;
+      break;
+    }
+  }
+
+  while (p < q) {
+    const uint8_t c = *p;
+    const bool delimiter =
+        wuffs_private_impl__parse_number_f64_stream__is_delimiter(c, options);
+
+    if (self->private_impl.phase !=
+        WUFFS_PRIVATE_IMPL__STREAM__PHASE__BETWEEN) {
+      if (!delimiter) {
+        wuffs_private_impl__parse_number_f64_stream__byte(self, c);
+      } else if (ret.num_values < dst_len) {
+        wuffs_private_impl__parse_number_f64_stream__emit(
+            &ret, dst, dst_error_bitmap,
+            wuffs_private_impl__parse_number_f64_stream__end_number(self));
+      } else {
+        break;
+      }
+      p++;
+      continue;
+
+    } else if (delimiter) {
+      p++;
+      continue;
+
+    } else if (ret.num_values >= dst_len) {
+      break;
+
+    } else if (p < last_delimiter) {
+      // The whole number is in src.
+      wuffs_base__slice_u8 s;
+      s.ptr = (uint8_t*)p;
+      s.len = (size_t)(last_delimiter - p);
+      wuffs_base__parse_number_f64_prefix__output o =
+          wuffs_base__parse_number_f64_prefix(s, options);
+      const uint8_t* end = p + o.num_bytes;
+      wuffs_base__result_f64 r;
+      r.status.repr = o.status.repr;
+      r.value = o.value;
+      if (!r.status.repr) {
+        s.len = o.num_bytes;
+        if (!wuffs_private_impl__parse_number_f64_stream__is_delimiter(
+                *end, options) ||
+            !wuffs_private_impl__parse_number__starts_like_a_number(s,
+                                                                    options)) {
+          r.status.repr = wuffs_base__error__bad_argument;
+          r.value = 0;
+        }
+      }
+      if (r.status.repr) {
+        // Skip the rest of the invalid number.
+        while (!wuffs_private_impl__parse_number_f64_stream__is_delimiter(
+            *end, options)) {
+          end++;
+        }
+      }
+      wuffs_private_impl__parse_number_f64_stream__emit(&ret, dst,
+                                                        dst_error_bitmap, r);
+      p = end;
+      continue;
+    }
+
+    // The number might continue past the end of src. Start the state machine.
+    self->private_impl.phase = WUFFS_PRIVATE_IMPL__STREAM__PHASE__START;
+    self->private_impl.negative = false;
+    self->private_impl.exp_negative = false;
+    self->private_impl.leading_zero = false;
+    self->private_impl.saw_integral_digits = false;
+    self->private_impl.num_sig_digits = 0;
+    self->private_impl.man = 0;
+    self->private_impl.exp10 = 0;
+    self->private_impl.exp_num = 0;
+    wuffs_private_impl__parse_number_f64_stream__byte(self, c);
+    p++;
+  }
+
+  ret.num_bytes = (size_t)(p - src.ptr);
+  return ret;
+}
+
+// wuffs_base__parse_number_f64_stream__finish ends the stream, writing the
+// last number to dst[0] (and dst_error_bitmap[0], as per
+// wuffs_base__parse_number_f64_stream__write) if there is one that hasn't
+// been ended by a delimiter. Its num_values is 0 or 1. dst_len must be
+// positive for that last number to be written. The state is then ready for
+// a new stream.
+static WUFFS_BASE__POTENTIALLY_UNUSED
+wuffs_base__parse_number_f64_stream__output  //
+wuffs_base__parse_number_f64_stream__finish(
+    wuffs_base__parse_number_f64_stream* self,
+    double* dst,
+    uint8_t* dst_error_bitmap,
+    size_t dst_len) {
+  wuffs_base__parse_number_f64_stream__output ret;
+  ret.num_values = 0;
+  ret.num_errors = 0;
+  ret.num_bytes = 0;
+  if ((self->private_impl.phase !=
+       WUFFS_PRIVATE_IMPL__STREAM__PHASE__BETWEEN) &&
+      (dst_len > 0)) {
+    wuffs_private_impl__parse_number_f64_stream__emit(
+        &ret, dst, dst_error_bitmap,
+        wuffs_private_impl__parse_number_f64_stream__end_number(self));
+  }
+  return ret;
+}
+
+// --------
+
+// wuffs_private_impl__man_exp10__to_f32_fast is like
+// wuffs_private_impl__man_exp10__to_f64_fast but produces an f32.
+static inline bool  //
+wuffs_private_impl__man_exp10__to_f32_fast(
+    const wuffs_private_impl__man_exp10* x,
+    float* dst) {
+  uint64_t man = x->man;
+  int32_t exp10 = x->exp10;
+
+  // If both man and (10 ** exp10) are exactly representable by a float, we
+  // don't need to run the Eisel-Lemire algorithm.
+  if ((-10 <= exp10) && (exp10 <= 10) && ((man >> 24) == 0)) {
+    float f = (float)man;
+    if (exp10 >= 0) {
+      f *= wuffs_private_impl__f32_powers_of_10[+exp10];
+    } else {
+      f /= wuffs_private_impl__f32_powers_of_10[-exp10];
+    }
+    *dst = x->negative ? -f : +f;
+    return true;
+  }
+
+  if ((man == 0) || (exp10 < -342) || (308 < exp10)) {
+    return false;
+  }
+
+  int64_t r = wuffs_private_impl__parse_number_f32_eisel_lemire(man, exp10);
+  if (r < 0) {
+    return false;
+  } else if (x->truncated) {
+    int64_t r1 =
+        wuffs_private_impl__parse_number_f32_eisel_lemire(man + 1, exp10);
+    if (r1 != r) {
+      return false;
+    }
+  }
+  *dst = wuffs_base__ieee_754_bit_representation__from_u32_to_f32(
+      ((uint32_t)r) | (((uint32_t)(x->negative)) << 31));
+  return true;
+}
+
+// wuffs_private_impl__parse_number_f32_fallback is the f32 counterpart of
+// wuffs_private_impl__parse_number_f64_fallback.
+static wuffs_base__result_f32  //
+wuffs_private_impl__parse_number_f32_fallback(wuffs_base__slice_u8 s,
+                                              uint32_t options) {
+  wuffs_private_impl__high_prec_dec h;
+  wuffs_base__status status =
+      wuffs_private_impl__parse_number__starts_like_a_number(s, options)
+          ? wuffs_private_impl__high_prec_dec__parse(&h, s, options)
+          : wuffs_base__make_status(wuffs_base__error__bad_argument);
+  if (status.repr) {
+    // Infinities and NaNs narrow exactly from f64 to f32.
+    wuffs_base__result_f64 r64 =
+        wuffs_private_impl__parse_number_f64_special(s, options);
+    wuffs_base__result_f32 ret;
+    ret.status = r64.status;
+    ret.value = (float)(r64.value);
+    return ret;
+  }
+  return wuffs_private_impl__high_prec_dec__to_f32(&h, options);
+}
+
+static WUFFS_BASE__FORCE_INLINE wuffs_base__result_f32  //
+wuffs_private_impl__parse_number_f32__inline(wuffs_base__slice_u8 s,
+                                             uint32_t options) {
+  do {
+    wuffs_private_impl__man_exp10 x;
+    if (!wuffs_private_impl__parse_number__scan_whole_man_exp10(&x, s, options,
+                                                                false)) {
+      goto fallback;
     }
-    return wuffs_private_impl__high_prec_dec__to_f64(&h, options);
+
+    wuffs_base__result_f32 ret;
+    if (!wuffs_private_impl__man_exp10__to_f32_fast(&x, &ret.value)) {
+      goto fallback;
+    }
+    ret.status.repr = NULL;
+    return ret;
   } while (0);
+
+fallback:
+  return wuffs_private_impl__parse_number_f32_fallback(s, options);
+}
+
+// wuffs_base__parse_number_f32 is like wuffs_base__parse_number_f64 but
+// produces an IEEE 754 single-precision value, correctly rounded from the
+// decimal input (not from an intermediate f64 value).
+static WUFFS_BASE__POTENTIALLY_UNUSED wuffs_base__result_f32  //
+wuffs_base__parse_number_f32(wuffs_base__slice_u8 s, uint32_t options) {
+  return wuffs_private_impl__parse_number_f32__inline(s, options);
+}
+
+// WUFFS_BASE__DEFINE_PARSE_NUMBER_F32 is like
+// WUFFS_BASE__DEFINE_PARSE_NUMBER_F64 but for wuffs_base__parse_number_f32.
+#define WUFFS_BASE__DEFINE_PARSE_NUMBER_F32(func_name, options_value)      \
+  static wuffs_base__result_f32 func_name(wuffs_base__slice_u8 s) {        \
+    return wuffs_private_impl__parse_number_f32__inline(                   \
+        s, (uint32_t)(options_value));                                     \
+  }
+
+// ---------------- String Conversions (Rendering)
+
+static size_t  //
+wuffs_private_impl__render_inf(wuffs_base__slice_u8 dst,
+                               bool neg,
+                               uint32_t options) {
+  const char* s = neg ? "-Inf"
+                  : (options & WUFFS_BASE__RENDER_NUMBER_XXX__LEADING_PLUS_SIGN)
+                      ? "+Inf"
+                      : "Inf";
+  size_t n = strlen(s);
+  if (n > dst.len) {
+    return 0;
+  }
+  uint8_t* ptr = (options & WUFFS_BASE__RENDER_NUMBER_XXX__ALIGN_RIGHT)
+                     ? &dst.ptr[dst.len - n]
+                     : &dst.ptr[0];
+  memcpy(ptr, s, n);
+  return n;
+}
+
+static size_t  //
+wuffs_private_impl__render_nan(wuffs_base__slice_u8 dst, uint32_t options) {
+  if (dst.len < 3) {
+    return 0;
+  }
+  uint8_t* ptr = (options & WUFFS_BASE__RENDER_NUMBER_XXX__ALIGN_RIGHT)
+                     ? &dst.ptr[dst.len - 3]
+                     : &dst.ptr[0];
+  memcpy(ptr, "NaN", 3);
+  return 3;
+}
+
+static size_t  //
+wuffs_private_impl__high_prec_dec__render_exponent_absent(
+    wuffs_base__slice_u8 dst,
+    wuffs_private_impl__high_prec_dec* h,
+    uint32_t precision,
+    uint32_t options) {
+  size_t n = (h->negative ||
+              (options & WUFFS_BASE__RENDER_NUMBER_XXX__LEADING_PLUS_SIGN))
+                 ? 1
+                 : 0;
+  if (h->decimal_point <= 0) {
+    n += 1;
+  } else {
+    n += (size_t)(h->decimal_point);
+  }
+  if (precision > 0) {
+    n += precision + 1;  // +1 for the '.'.
+  }
+
+  // Don't modify dst if the formatted number won't fit.
+  if (n > dst.len) {
+    return 0;
+  }
+
+  // Align-left or align-right.
+  uint8_t* ptr = (options & WUFFS_BASE__RENDER_NUMBER_XXX__ALIGN_RIGHT)
+                     ? &dst.ptr[dst.len - n]
+                     : &dst.ptr[0];
+
+  // Leading "±".
+  if (h->negative) {
+    *ptr++ = '-';
+  } else if (options & WUFFS_BASE__RENDER_NUMBER_XXX__LEADING_PLUS_SIGN) {
+    *ptr++ = '+';
+  }
+
+  // Integral digits.
+  if (h->decimal_point <= 0) {
+    *ptr++ = '0';
+  } else {
+    uint32_t m = h->num_digits;
+    if (m > (uint32_t)(h->decimal_point)) {
+      m = (uint32_t)(h->decimal_point);
+    }
+    uint32_t i = 0;
+    for (; i < m; i++) {
+      *ptr++ = (uint8_t)('0' | h->digits[i]);
+    }
+    for (; i < (uint32_t)(h->decimal_point); i++) {
+      *ptr++ = '0';
+    }
+  }
+
+  // Separator and then fractional digits. When h->decimal_point is negative,
+  // the uint32_t j overflows but still indexes the right digit (or is out of
+  // bounds, for leading zeroes).
+  if (precision > 0) {
+    *ptr++ =
+        (options & WUFFS_BASE__RENDER_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA)
+            ? ','
+            : '.';
+    uint32_t i = 0;
+    for (; i < precision; i++) {
+      uint32_t j = ((uint32_t)(h->decimal_point)) + i;
+      *ptr++ = (uint8_t)('0' | ((j < h->num_digits) ? h->digits[j] : 0));
+    }
+  }
+
+  return n;
+}
+
+static size_t  //
+wuffs_private_impl__high_prec_dec__render_exponent_present(
+    wuffs_base__slice_u8 dst,
+    wuffs_private_impl__high_prec_dec* h,
+    uint32_t precision,
+    uint32_t options) {
+  int32_t exp = 0;
+  if (h->num_digits > 0) {
+    exp = h->decimal_point - 1;
+  }
+  bool negative_exp = exp < 0;
+  if (negative_exp) {
+    exp = -exp;
+  }
+
+  size_t n = (h->negative ||
+              (options & WUFFS_BASE__RENDER_NUMBER_XXX__LEADING_PLUS_SIGN))
+                 ? 4
+                 : 3;  // Minimum 3 bytes: first digit and then "e±".
+  if (precision > 0) {
+    n += precision + 1;  // +1 for the '.'.
+  }
+  n += (exp < 100) ? 2 : 3;
+
+  // Don't modify dst if the formatted number won't fit.
+  if (n > dst.len) {
+    return 0;
+  }
+
+  // Align-left or align-right.
+  uint8_t* ptr = (options & WUFFS_BASE__RENDER_NUMBER_XXX__ALIGN_RIGHT)
+                     ? &dst.ptr[dst.len - n]
+                     : &dst.ptr[0];
+
+  // Leading "±".
+  if (h->negative) {
+    *ptr++ = '-';
+  } else if (options & WUFFS_BASE__RENDER_NUMBER_XXX__LEADING_PLUS_SIGN) {
+    *ptr++ = '+';
+  }
+
+  // Integral digit.
+  if (h->num_digits > 0) {
+    *ptr++ = (uint8_t)('0' | h->digits[0]);
+  } else {
+    *ptr++ = '0';
+  }
+
+  // Separator and then fractional digits.
+  if (precision > 0) {
+    *ptr++ =
+        (options & WUFFS_BASE__RENDER_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA)
+            ? ','
+            : '.';
+    uint32_t i = 1;
+    uint32_t j = h->num_digits;
+    if (j > (precision + 1)) {
+      j = precision + 1;
+    }
+    for (; i < j; i++) {
+      *ptr++ = (uint8_t)('0' | h->digits[i]);
+    }
+    for (; i <= precision; i++) {
+      *ptr++ = '0';
+    }
+  }
+
+  // Exponent.
+  *ptr++ = 'e';
+  *ptr++ = negative_exp ? '-' : '+';
+  if (exp < 10) {
+    *ptr++ = '0';
+    *ptr++ = (uint8_t)('0' | exp);
+  } else if (exp < 100) {
+    *ptr++ = (uint8_t)('0' | (exp / 10));
+    *ptr++ = (uint8_t)('0' | (exp % 10));
+  } else {
+    int32_t e = exp / 100;
+    exp -= e * 100;
+    *ptr++ = (uint8_t)('0' | e);
+    *ptr++ = (uint8_t)('0' | (exp / 10));
+    *ptr++ = (uint8_t)('0' | (exp % 10));
+  }
+
+  return n;
+}
+
+// --------
+
+// wuffs_private_impl__render_number_f64__rop returns an approximation to ((g
+// * cp) >> 127), where g is the 126-bit (g1 * (2 ** 63)) + g0, with its low
+// bit set if the approximation is inexact ("round to odd").
+static inline uint64_t  //
+wuffs_private_impl__render_number_f64__rop(uint64_t g1,
+                                           uint64_t g0,
+                                           uint64_t cp) {
+  uint64_t x1 = wuffs_base__multiply_u64(g0, cp).hi;
+  wuffs_base__multiply_u64__output y = wuffs_base__multiply_u64(g1, cp);
+  uint64_t z = (y.lo >> 1) + x1;
+  uint64_t vbp = y.hi + (z >> 63);
+  return vbp | (((z & 0x7FFFFFFFFFFFFFFF) + 0x7FFFFFFFFFFFFFFF) >> 63);
+}
+
+// wuffs_private_impl__render_number_f64__shortest_decimal finds the shortest
+// decimal, (*dst_man * (10 ** *dst_exp10)), that parses back to the positive
+// f64 value (c * (2 ** q)). When there's more than one shortest decimal, it
+// picks the one closest to that f64 value. Trailing zeroes in *dst_man are
+// allowed.
+//
+// It implements Raffaello Giulietti's Schubfach algorithm. See "The
+// Schubfach way to render doubles" (https://drive.google.com/file/d/
+// 1gp5xv4CAa78SVgCeWfGqqI4FfYYYuNFb). Schubfach multiplies by a 126-bit
+// approximation to a power of 10, rounded up. That comes from the (rounded
+// down) 128-bit wuffs_private_impl__powers_of_10 entries, so that parsing and
+// rendering share one look-up table.
+//
+// Preconditions:
+//  - c is non-zero and less than (1 << 53).
+//  - q is in the range [-1074 ..= 971].
+static void  //
+wuffs_private_impl__render_number_f64__shortest_decimal(uint64_t* dst_man,
+                                                        int32_t* dst_exp10,
+                                                        uint64_t c,
+                                                        int32_t q) {
+  // The interval of decimals that round to (c * (2 ** q)) is bounded by cbl
+  // and cbr (all of these have 2 extra bits of precision, so that halfway
+  // points are integers). It is symmetric unless c is a power of 2, in which
+  // case the lower neighbor is closer. k is the base-10 exponent, such that
+  // (10 ** k) is just below that interval's width, using the magic constants
+  // from the paper for floor(q * log10(2)) and floor(q * log10(2) +
+  // log10(3/4)).
+  uint64_t out = c & 1;
+  uint64_t cb = c << 2;
+  uint64_t cbr = cb + 2;
+  uint64_t cbl;
+  int32_t k;
+  if ((c != 0x0010000000000000) || (q == -1074)) {
+    cbl = cb - 2;
+    k = (int32_t)((((int64_t)q) * 661971961083) >> 41);
+  } else {
+    cbl = cb - 1;
+    k = (int32_t)(((((int64_t)q) * 661971961083) - 274743187321) >> 41);
+  }
+
+  // Look up (10 ** -k). g is the 126-bit floor(entry / 4) + 1. See
+  // wuffs_private_impl__parse_number_f64_eisel_lemire for the 217706 magic
+  // constant: ((217706 * e) >> 16) is floor(e * log2(10)).
+  const uint64_t* po10 = &wuffs_private_impl__powers_of_10[342 - k][0];
+  uint64_t g_hi = po10[1] >> 2;
+  uint64_t g_lo = (po10[0] >> 2) | (po10[1] << 62);
+  g_lo++;
+  g_hi += (g_lo == 0) ? 1 : 0;
+  uint64_t g1 = (g_hi << 1) | (g_lo >> 63);
+  uint64_t g0 = g_lo & 0x7FFFFFFFFFFFFFFF;
+  int32_t h = q + ((217706 * -k) >> 16) + 2;
+
+  uint64_t vb = wuffs_private_impl__render_number_f64__rop(g1, g0, cb << h);
+  uint64_t vbl = wuffs_private_impl__render_number_f64__rop(g1, g0, cbl << h);
+  uint64_t vbr = wuffs_private_impl__render_number_f64__rop(g1, g0, cbr << h);
+
+  // Try a multiple of 10 (one digit fewer) first. Unlike Java's
+  // Double.toString, which always produces at least two digits, this also
+  // applies when s has only two digits, so that 4.9e-324 (the smallest
+  // subnormal) is rendered as "5e-324".
+  uint64_t s = vb >> 2;
+  if (s >= 10) {
+    uint64_t sp10 = 10 * (s / 10);
+    uint64_t tp10 = sp10 + 10;
+    bool upin = (vbl + out) <= (sp10 << 2);
+    bool wpin = ((tp10 << 2) + out) <= vbr;
+    if (upin != wpin) {
+      *dst_man = upin ? sp10 : tp10;
+      *dst_exp10 = k;
+      return;
+    }
+  }
+
+  // Otherwise, pick s or (s + 1), whichever is in the interval. If both are,
+  // pick the closer one, with ties to even.
+  uint64_t t = s + 1;
+  bool uin = (vbl + out) <= (s << 2);
+  bool win = ((t << 2) + out) <= vbr;
+  if (uin != win) {
+    *dst_man = uin ? s : t;
+  } else {
+    int64_t cmp = (int64_t)(vb - ((s + t) << 1));
+    *dst_man = ((cmp < 0) || ((cmp == 0) && ((s & 1) == 0))) ? s : t;
+  }
+  *dst_exp10 = k;
+}
+
+// wuffs_base__render_number_f64 writes the decimal encoding of x to dst and
+// returns the number of bytes written. If dst is shorter than the entire
+// encoding, it returns 0 (and no bytes are written).
+//
+// For those familiar with C's printf or Go's fmt.Printf functions:
+//  - "%e" means the WUFFS_BASE__RENDER_NUMBER_FXX__EXPONENT_PRESENT option.
+//  - "%f" means the WUFFS_BASE__RENDER_NUMBER_FXX__EXPONENT_ABSENT  option.
+//  - "%g" means neither or both bits are set.
+//
+// The precision argument controls the number of digits rendered, excluding
+// the exponent (the "e+05" in "1.23e+05"):
+//  - for "%e" and "%f" it is the number of digits after the decimal separator,
+//  - for "%g" it is the number of significant digits (and trailing zeroes are
+//    removed).
+//
+// A precision of 6 gives the same output as printf's defaults. A precision
+// greater than 4095 is equivalent to 4095.
+//
+// The precision argument is ignored when the
+// WUFFS_BASE__RENDER_NUMBER_FXX__JUST_ENOUGH_PRECISION option is set. That
+// shortest round-trip mode is the fast one: it finds its digits with the same
+// wuffs_private_impl__powers_of_10 table that parsing uses. The fixed
+// precision modes compute the exact decimal expansion of x (in a
+// wuffs_private_impl__high_prec_dec) and then round it, like printf does.
+//
+// Extreme values of x will be rendered as "NaN", "Inf" (or "+Inf" if the
+// WUFFS_BASE__RENDER_NUMBER_XXX__LEADING_PLUS_SIGN option is set) or "-Inf".
+static WUFFS_BASE__POTENTIALLY_UNUSED size_t  //
+wuffs_base__render_number_f64(wuffs_base__slice_u8 dst,
+                              double x,
+                              uint32_t precision,
+                              uint32_t options) {
+  // Decompose x (64 bits) into negativity (1 bit), base-2 exponent (11 bits
+  // with a -1023 bias) and mantissa (52 bits).
+  uint64_t bits = wuffs_base__ieee_754_bit_representation__from_f64_to_u64(x);
+  bool neg = (bits >> 63) != 0;
+  int32_t exp2 = ((int32_t)(bits >> 52)) & 0x7FF;
+  uint64_t man = bits & 0x000FFFFFFFFFFFFF;
+
+  // Apply the exponent bias and set the implicit top bit of the mantissa,
+  // unless x is subnormal. Also take care of Inf and NaN.
+  if (exp2 == 0x7FF) {
+    if (man != 0) {
+      return wuffs_private_impl__render_nan(dst, options);
+    }
+    return wuffs_private_impl__render_inf(dst, neg, options);
+  } else if (exp2 == 0) {
+    exp2 = -1022;
+  } else {
+    exp2 -= 1023;
+    man |= 0x0010000000000000;
+  }
+
+  // Ensure that precision isn't too large.
+  if (precision > 4095) {
+    precision = 4095;
+  }
+
+  // Convert from the (neg, exp2, man) tuple to an HPD: either the shortest
+  // decimal that round-trips or the exact value.
+  wuffs_private_impl__high_prec_dec h;
+  bool just_enough =
+      options & WUFFS_BASE__RENDER_NUMBER_FXX__JUST_ENOUGH_PRECISION;
+  if (man == 0) {
+    wuffs_private_impl__high_prec_dec__assign(&h, 0, neg);
+  } else if (just_enough) {
+    uint64_t dec_man = 0;
+    int32_t dec_exp10 = 0;
+    int32_t q = exp2 - 52;  // 52 mantissa bits.
+    if ((0 < -q) && (-q < 53) && ((man & ((1ull << -q) - 1)) == 0)) {
+      // x is an integer in [1 ..= 1<<53], which is exactly representable.
+      dec_man = man >> -q;
+    } else {
+      wuffs_private_impl__render_number_f64__shortest_decimal(
+          &dec_man, &dec_exp10, man, q);
+    }
+    wuffs_private_impl__high_prec_dec__assign(&h, dec_man, neg);
+    h.decimal_point += dec_exp10;
+  } else {
+    wuffs_private_impl__high_prec_dec__assign(&h, man, neg);
+    wuffs_private_impl__high_prec_dec__lshift(&h, exp2 - 52);
+  }
+
+  // Handle the "%e" and "%f" formats.
+  switch (options & (WUFFS_BASE__RENDER_NUMBER_FXX__EXPONENT_ABSENT |
+                     WUFFS_BASE__RENDER_NUMBER_FXX__EXPONENT_PRESENT)) {
+    case WUFFS_BASE__RENDER_NUMBER_FXX__EXPONENT_ABSENT:  // The "%f" format.
+      if (just_enough) {
+        int32_t p = ((int32_t)(h.num_digits)) - h.decimal_point;
+        precision = (p > 0) ? ((uint32_t)p) : 0;
+      } else {
+        wuffs_private_impl__high_prec_dec__round_nearest(
+            &h, ((int32_t)precision) + h.decimal_point);
+      }
+      return wuffs_private_impl__high_prec_dec__render_exponent_absent(
+          dst, &h, precision, options);
+
+    case WUFFS_BASE__RENDER_NUMBER_FXX__EXPONENT_PRESENT:  // The "%e" format.
+      if (just_enough) {
+        precision = (h.num_digits > 0) ? (h.num_digits - 1) : 0;
+      } else {
+        wuffs_private_impl__high_prec_dec__round_nearest(
+            &h, ((int32_t)precision) + 1);
+      }
+      return wuffs_private_impl__high_prec_dec__render_exponent_present(
+          dst, &h, precision, options);
+  }
+
+  // We have the "%g" format and so precision means the number of significant
+  // digits, not the number of digits after the decimal separator. Perform
+  // rounding and determine whether to use "%e" or "%f".
+  int32_t e_threshold = 0;
+  if (just_enough) {
+    precision = h.num_digits;
+    e_threshold = 6;
+  } else {
+    if (precision == 0) {
+      precision = 1;
+    }
+    wuffs_private_impl__high_prec_dec__round_nearest(&h, ((int32_t)precision));
+    e_threshold = ((int32_t)precision);
+    int32_t nd = ((int32_t)(h.num_digits));
+    if ((e_threshold > nd) && (nd >= h.decimal_point)) {
+      e_threshold = nd;
+    }
+  }
+
+  // Use the "%e" format if the exponent is large.
+  int32_t e = h.decimal_point - 1;
+  if ((e < -4) || (e_threshold <= e)) {
+    uint32_t p = precision;
+    if (p > h.num_digits) {
+      p = h.num_digits;
+    }
+    return wuffs_private_impl__high_prec_dec__render_exponent_present(
+        dst, &h, (p > 0) ? (p - 1) : 0, options);
+  }
+
+  // Use the "%f" format otherwise.
+  int32_t p = ((int32_t)precision);
+  if (p > h.decimal_point) {
+    p = ((int32_t)(h.num_digits));
+  }
+  p -= h.decimal_point;
+  precision = (p > 0) ? ((uint32_t)p) : 0;
+  return wuffs_private_impl__high_prec_dec__render_exponent_absent(
+      dst, &h, precision, options);
 }
 
-static int
+static WUFFS_BASE__POTENTIALLY_UNUSED int
 wuffs_double_from_str(char *ptr, size_t len, double *d)
 {
  wuffs_base__slice_u8 slice = {.ptr = (uint8_t *)ptr, .len = len};
  wuffs_base__result_f64 res = wuffs_base__parse_number_f64(slice, 0);
  *d = res.value;
  return wuffs_base__status__is_ok(&res.status);
-}
\ No newline at end of file
+}
+
+static WUFFS_BASE__POTENTIALLY_UNUSED int
+wuffs_float_from_str(char *ptr, size_t len, float *f)
+{
+ wuffs_base__slice_u8 slice = {.ptr = (uint8_t *)ptr, .len = len};
+ wuffs_base__result_f32 res = wuffs_base__parse_number_f32(slice, 0);
+ *f = res.value;
+ return wuffs_base__status__is_ok(&res.status);
+}
+
+static WUFFS_BASE__POTENTIALLY_UNUSED size_t
+wuffs_double_to_str(char *ptr, size_t len, double d)
+{
+ wuffs_base__slice_u8 slice = {.ptr = (uint8_t *)ptr, .len = len};
+ return wuffs_base__render_number_f64(
+     slice, d, 0, WUFFS_BASE__RENDER_NUMBER_FXX__JUST_ENOUGH_PRECISION);
+}
@@ -0,0 +1,271 @@
+#pragma once
+
+// This file adds memoization caches on top of wuffs_eisel_lemire.c, for
+// inputs (such as low-cardinality market data or log columns) that repeat the
+// same few thousand short strings, like "0.00", "100" or "1.5", over and over.
+// A hit replaces the parse with a hash, two 64-bit compares and a load.
+//
+// It is optional and separate from the core parser, since whether a cache
+// pays off depends on the workload. Check the hit rate (see
+// wuffs_base__parse_number_f64_cache__stats) before committing to one.
+
+#include "wuffs_eisel_lemire.c"
+
+// ---------------- Memoization Caches
+
+// WUFFS_BASE__PARSE_NUMBER_F64_CACHE__MAX_KEY_LEN is the longest input that
+// the caches hold. Such inputs fit in two uint64_t words. Longer ones are
+// always parsed.
+#define WUFFS_BASE__PARSE_NUMBER_F64_CACHE__MAX_KEY_LEN 16
+
+// WUFFS_BASE__PARSE_NUMBER_F64_CACHE__NUM_SETS is the number of sets (of 2
+// entries each) in a cache. Each set is one 64-byte cache line, so a cache is
+// 64 KiB. It must be a power of 2.
+#if !defined(WUFFS_BASE__PARSE_NUMBER_F64_CACHE__NUM_SETS)
+#define WUFFS_BASE__PARSE_NUMBER_F64_CACHE__NUM_SETS 1024
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WUFFS_PRIVATE_IMPL__CACHE_LINE_ALIGNED __attribute__((aligned(64)))
+#else
+#define WUFFS_PRIVATE_IMPL__CACHE_LINE_ALIGNED
+#endif
+
+// wuffs_base__parse_number_f64_cache__stats counts how the lookups went. The
+// hit rate is num_hits divided by the sum of all three.
+typedef struct wuffs_base__parse_number_f64_cache__stats__struct {
+  // num_hits counts the inputs that were found in the cache.
+  uint64_t num_hits;
+  // num_misses counts the inputs that were parsed and (if valid) inserted.
+  uint64_t num_misses;
+  // num_bypasses counts the inputs that were too long (or empty) to cache.
+  uint64_t num_bypasses;
+} wuffs_base__parse_number_f64_cache__stats;
+
+// wuffs_private_impl__parse_number_f64_cache__entry is one cached input (the
+// key) and its value. The low 8 bits of meta are the key's length, where 0
+// means an empty entry. The shared cache uses the other bits of meta as a
+// sequence number (see wuffs_base__parse_number_f64_shared_cache).
+typedef struct wuffs_private_impl__parse_number_f64_cache__entry__struct {
+  uint64_t key0;
+  uint64_t key1;
+  uint64_t value_bits;
+  uint64_t meta;
+} wuffs_private_impl__parse_number_f64_cache__entry;
+
+typedef struct wuffs_private_impl__parse_number_f64_cache__set__struct {
+  wuffs_private_impl__parse_number_f64_cache__entry ways[2];
+} WUFFS_PRIVATE_IMPL__CACHE_LINE_ALIGNED
+    wuffs_private_impl__parse_number_f64_cache__set;
+
+// wuffs_private_impl__parse_number_f64_cache__key packs s (which must be
+// 1 to 16 bytes long) into two words and returns the set index. Two inputs of
+// the same length have the same words if and only if they have the same
+// bytes.
+//
+// It uses (possibly overlapping) loads that stay within s, instead of a
+// variable length memcpy into a zeroed buffer, which costs about as much as
+// parsing a short number.
+static inline size_t  //
+wuffs_private_impl__parse_number_f64_cache__key(wuffs_base__slice_u8 s,
+                                                uint64_t* key0,
+                                                uint64_t* key1) {
+  const uint8_t* p = s.ptr;
+  size_t n = s.len;
+  if (n > 8) {
+    *key0 = wuffs_base__peek_u64le__no_bounds_check(p);
+    *key1 = wuffs_base__peek_u64le__no_bounds_check(p + n - 8) >>
+            (8 * (16 - n));
+  } else if (n >= 4) {
+    *key0 = ((uint64_t)wuffs_base__peek_u32le__no_bounds_check(p)) |
+            (((uint64_t)wuffs_base__peek_u32le__no_bounds_check(p + n - 4) >>
+              (8 * (8 - n)))
+             << 32);
+    *key1 = 0;
+  } else {
+    *key0 = ((uint64_t)p[0]) | (((uint64_t)p[n >> 1]) << 8) |
+            (((uint64_t)p[n - 1]) << 16);
+    *key1 = 0;
+  }
+  uint64_t h = (*key0 * 0x9E3779B97F4A7C15) ^ (*key1 * 0xC2B2AE3D27D4EB4F) ^
+               (uint64_t)s.len;
+  h ^= h >> 29;
+  h *= 0xBF58476D1CE4E5B9;
+  h ^= h >> 32;
+  return (size_t)(h & (WUFFS_BASE__PARSE_NUMBER_F64_CACHE__NUM_SETS - 1));
+}
+
+// --------
+
+// wuffs_base__parse_number_f64_cache is a cache for one thread's use (for
+// example, a thread_local variable, or one per worker). Lookups and inserts
+// are plain loads and stores.
+//
+// Call wuffs_base__parse_number_f64_cache__initialize before any other
+// wuffs_base__parse_number_f64_cache__etc function.
+typedef struct wuffs_base__parse_number_f64_cache__struct {
+  wuffs_private_impl__parse_number_f64_cache__set
+      sets[WUFFS_BASE__PARSE_NUMBER_F64_CACHE__NUM_SETS];
+  uint32_t options;
+  wuffs_base__parse_number_f64_cache__stats stats;
+} wuffs_base__parse_number_f64_cache;
+
+// wuffs_base__parse_number_f64_cache__initialize empties the cache and zeroes
+// its stats. options is passed to every wuffs_base__parse_number_f64 call.
+static WUFFS_BASE__POTENTIALLY_UNUSED void  //
+wuffs_base__parse_number_f64_cache__initialize(
+    wuffs_base__parse_number_f64_cache* self,
+    uint32_t options) {
+  memset(self, 0, sizeof(*self));
+  self->options = options;
+}
+
+// wuffs_base__parse_number_f64_cache__parse is equivalent to
+// wuffs_base__parse_number_f64(s, self->options), consulting the cache
+// first. Only successfully parsed inputs are inserted.
+static WUFFS_BASE__POTENTIALLY_UNUSED wuffs_base__result_f64  //
+wuffs_base__parse_number_f64_cache__parse(
+    wuffs_base__parse_number_f64_cache* self,
+    wuffs_base__slice_u8 s) {
+  if ((s.len == 0) ||
+      (s.len > WUFFS_BASE__PARSE_NUMBER_F64_CACHE__MAX_KEY_LEN)) {
+    self->stats.num_bypasses++;
+    return wuffs_base__parse_number_f64(s, self->options);
+  }
+
+  uint64_t key0;
+  uint64_t key1;
+  wuffs_private_impl__parse_number_f64_cache__set* set =
+      &self->sets[wuffs_private_impl__parse_number_f64_cache__key(s, &key0,
+                                                                  &key1)];
+  int w;
+  for (w = 0; w < 2; w++) {
+    wuffs_private_impl__parse_number_f64_cache__entry* e = &set->ways[w];
+    if ((e->key0 == key0) && (e->key1 == key1) && (e->meta == s.len)) {
+      self->stats.num_hits++;
+      wuffs_base__result_f64 ret;
+      ret.status.repr = NULL;
+      ret.value = wuffs_base__ieee_754_bit_representation__from_u64_to_f64(
+          e->value_bits);
+      return ret;
+    }
+  }
+
+  self->stats.num_misses++;
+  wuffs_base__result_f64 ret = wuffs_base__parse_number_f64(s, self->options);
+  if (!ret.status.repr) {
+    // Fill an empty way, if there is one. Otherwise, evict way 1 and move
+    // way 0 down, so that way 0 is the most recently inserted.
+    wuffs_private_impl__parse_number_f64_cache__entry* e = &set->ways[0];
+    if (e->meta != 0) {
+      set->ways[1] = set->ways[0];
+    }
+    e->key0 = key0;
+    e->key1 = key1;
+    e->value_bits =
+        wuffs_base__ieee_754_bit_representation__from_f64_to_u64(ret.value);
+    e->meta = s.len;
+  }
+  return ret;
+}
+
+// --------
+
+// wuffs_base__parse_number_f64_shared_cache is a cache that many threads can
+// use at once, for read-mostly workloads where the set of distinct inputs
+// settles down quickly. Lookups take no locks and write no shared memory
+// (the stats are per-caller), so that concurrent hits don't bounce cache
+// lines between cores.
+//
+// Each entry is guarded by a sequence number in its meta field, like a
+// seqlock: a writer makes it odd (with a compare-and-swap, giving up if
+// another writer holds it), updates the entry and then makes it even again.
+// A reader checks that the sequence number was even and unchanged around
+// its reads, treating anything else as a miss.
+//
+// Call wuffs_base__parse_number_f64_shared_cache__initialize before any other
+// wuffs_base__parse_number_f64_shared_cache__etc function.
+typedef struct wuffs_base__parse_number_f64_shared_cache__struct {
+  wuffs_private_impl__parse_number_f64_cache__set
+      sets[WUFFS_BASE__PARSE_NUMBER_F64_CACHE__NUM_SETS];
+  uint32_t options;
+} wuffs_base__parse_number_f64_shared_cache;
+
+static WUFFS_BASE__POTENTIALLY_UNUSED void  //
+wuffs_base__parse_number_f64_shared_cache__initialize(
+    wuffs_base__parse_number_f64_shared_cache* self,
+    uint32_t options) {
+  memset(self, 0, sizeof(*self));
+  self->options = options;
+}
+
+// wuffs_base__parse_number_f64_shared_cache__parse is like
+// wuffs_base__parse_number_f64_cache__parse. It adds to *stats, which should
+// be owned by the calling thread, and which may be NULL.
+static WUFFS_BASE__POTENTIALLY_UNUSED wuffs_base__result_f64  //
+wuffs_base__parse_number_f64_shared_cache__parse(
+    wuffs_base__parse_number_f64_shared_cache* self,
+    wuffs_base__parse_number_f64_cache__stats* stats,
+    wuffs_base__slice_u8 s) {
+  wuffs_base__parse_number_f64_cache__stats ignored;
+  if (!stats) {
+    stats = &ignored;
+  }
+  if ((s.len == 0) ||
+      (s.len > WUFFS_BASE__PARSE_NUMBER_F64_CACHE__MAX_KEY_LEN)) {
+    stats->num_bypasses++;
+    return wuffs_base__parse_number_f64(s, self->options);
+  }
+
+  uint64_t key0;
+  uint64_t key1;
+  size_t index =
+      wuffs_private_impl__parse_number_f64_cache__key(s, &key0, &key1);
+  int w;
+  for (w = 0; w < 2; w++) {
+    wuffs_private_impl__parse_number_f64_cache__entry* e =
+        &self->sets[index].ways[w];
+    uint64_t meta = __atomic_load_n(&e->meta, __ATOMIC_ACQUIRE);
+    if (((meta & 0xFF) != s.len) || (meta & 0x100) ||
+        (__atomic_load_n(&e->key0, __ATOMIC_RELAXED) != key0) ||
+        (__atomic_load_n(&e->key1, __ATOMIC_RELAXED) != key1)) {
+      continue;
+    }
+    uint64_t value_bits = __atomic_load_n(&e->value_bits, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&e->meta, __ATOMIC_RELAXED) != meta) {
+      continue;
+    }
+    stats->num_hits++;
+    wuffs_base__result_f64 ret;
+    ret.status.repr = NULL;
+    ret.value =
+        wuffs_base__ieee_754_bit_representation__from_u64_to_f64(value_bits);
+    return ret;
+  }
+
+  stats->num_misses++;
+  wuffs_base__result_f64 ret = wuffs_base__parse_number_f64(s, self->options);
+  if (!ret.status.repr) {
+    // Replace one of the ways, picked by the hash's next bit. There's no
+    // moving of entries between ways, which would need both locked.
+    wuffs_private_impl__parse_number_f64_cache__entry* e =
+        &self->sets[index].ways[(key0 ^ key1 ^ s.len) & 1];
+    uint64_t meta = __atomic_load_n(&e->meta, __ATOMIC_RELAXED);
+    if (!(meta & 0x100) &&
+        __atomic_compare_exchange_n(&e->meta, &meta, meta | 0x100, false,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      __atomic_thread_fence(__ATOMIC_RELEASE);
+      __atomic_store_n(&e->key0, key0, __ATOMIC_RELAXED);
+      __atomic_store_n(&e->key1, key1, __ATOMIC_RELAXED);
+      __atomic_store_n(
+          &e->value_bits,
+          wuffs_base__ieee_754_bit_representation__from_f64_to_u64(ret.value),
+          __ATOMIC_RELAXED);
+      // Bump the sequence number (bits 9 and up) and clear the writing bit.
+      __atomic_store_n(&e->meta, ((meta & ~(uint64_t)0x1FF) + 0x200) | s.len,
+                       __ATOMIC_RELEASE);
+    }
+  }
+  return ret;
+}
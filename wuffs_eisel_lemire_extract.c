@@ -0,0 +1,451 @@
+#pragma once
+
+// This file adds extractors on top of wuffs_eisel_lemire.c. They find the
+// numbers in larger, structured text (such as CSV or JSON) and convert them
+// in the same pass over the bytes, without building any intermediate
+// representation.
+
+#include "wuffs_eisel_lemire.c"
+
+// ---------------- CSV
+
+// wuffs_base__csv_columns describes where wuffs_base__csv_extract_f64_columns
+// writes its output, in struct-of-arrays form: one array per selected column.
+typedef struct wuffs_base__csv_columns__struct {
+  // column_indexes[k] is the 0-based index, within each record, of the k-th
+  // selected column. They need not be sorted but must be distinct.
+  const size_t* column_indexes;
+  size_t num_columns;
+
+  // values[k] is an array of capacity doubles for the k-th selected column.
+  double** values;
+
+  // validity[k], if validity is non-NULL, is a bitmap of ((capacity + 7) / 8)
+  // bytes for the k-th selected column. Bit (i & 7) of validity[k][i >> 3] is
+  // set if and only if row i's field parsed as a number. Otherwise (the field
+  // was missing, empty or not a number) values[k][i] is zero.
+  uint8_t** validity;
+
+  size_t capacity;
+} wuffs_base__csv_columns;
+
+// wuffs_base__csv_extract_f64_columns__output is the result of
+// wuffs_base__csv_extract_f64_columns.
+typedef struct wuffs_base__csv_extract_f64_columns__output__struct {
+  wuffs_base__status status;
+  // num_rows is how many records were extracted, starting at row 0 of each
+  // output array.
+  size_t num_rows;
+  // num_bytes is how many bytes of src were consumed. It is less than
+  // src.len only if the output filled up first, in which case the caller can
+  // resume from (src.ptr + num_bytes).
+  size_t num_bytes;
+} wuffs_base__csv_extract_f64_columns__output;
+
+// WUFFS_PRIVATE_IMPL__CSV__SLOT_TABLE_LEN is how many leading column indexes
+// get a look-up table entry. Selected columns further to the right still
+// work, with a linear search.
+#define WUFFS_PRIVATE_IMPL__CSV__SLOT_TABLE_LEN 1024
+
+// wuffs_private_impl__csv__skip_field returns a pointer to the byte that ends
+// the field starting at p: a delimiter, a '\n' or q. A field that starts with
+// a '"' is quoted, and can contain delimiters, newlines and "" escapes.
+static inline const uint8_t*  //
+wuffs_private_impl__csv__skip_field(const uint8_t* p,
+                                    const uint8_t* q,
+                                    uint8_t delimiter) {
+  if ((p < q) && (*p == '"')) {
+    p++;
+    while (true) {
+      p = (const uint8_t*)memchr(p, '"', (size_t)(q - p));
+      if (!p) {
+        return q;
+      }
+      p++;
+      if ((p < q) && (*p == '"')) {
+        p++;
+        continue;
+      }
+      break;
+    }
+  }
+  for (; (p < q) && (*p != delimiter) && (*p != '\n'); p++) {
+  }
+  return p;
+}
+
+// wuffs_private_impl__csv__ends_field returns whether p is at the end of a
+// field: a delimiter, a '\n', a "\r\n" or q.
+static inline bool  //
+wuffs_private_impl__csv__ends_field(const uint8_t* p,
+                                    const uint8_t* q,
+                                    uint8_t delimiter) {
+  return (p >= q) || (*p == delimiter) || (*p == '\n') ||
+         ((*p == '\r') && (((p + 1) >= q) || (p[1] == '\n')));
+}
+
+// wuffs_private_impl__csv__parse_field parses the field starting at p into
+// *dst, returning a pointer to the byte that ends the field (see
+// wuffs_private_impl__csv__skip_field) and setting *ok.
+static inline const uint8_t*  //
+wuffs_private_impl__csv__parse_field(double* dst,
+                                     bool* ok,
+                                     const uint8_t* p,
+                                     const uint8_t* q,
+                                     uint8_t delimiter,
+                                     uint32_t options) {
+  *dst = 0;
+  *ok = false;
+  if ((p < q) && (*p != '"')) {
+    // Find the number and its end in one pass, instead of finding the field's
+    // end (a delimiter) first and then parsing the field.
+    wuffs_base__slice_u8 s;
+    s.ptr = (uint8_t*)p;
+    s.len = (size_t)(q - p);
+    wuffs_base__parse_number_f64_prefix__output o =
+        wuffs_base__parse_number_f64_prefix(s, options);
+    const uint8_t* r = p + o.num_bytes;
+    if (!o.status.repr &&
+        wuffs_private_impl__csv__ends_field(r, q, delimiter)) {
+      *dst = o.value;
+      *ok = true;
+      return (r < q) && (*r == '\r') ? (r + 1) : r;
+    }
+  } else if (p < q) {
+    // A quoted number, such as "1.5" (including the quotes). Anything with
+    // a "" escape inside can't be a number.
+    const uint8_t* r = (const uint8_t*)memchr(p + 1, '"', (size_t)(q - p - 1));
+    if (r && wuffs_private_impl__csv__ends_field(r + 1, q, delimiter)) {
+      wuffs_base__slice_u8 s;
+      s.ptr = (uint8_t*)(p + 1);
+      s.len = (size_t)(r - (p + 1));
+      wuffs_base__result_f64 res = wuffs_base__parse_number_f64(s, options);
+      if (!res.status.repr) {
+        *dst = res.value;
+        *ok = true;
+      }
+      r++;
+      return (r < q) && (*r == '\r') ? (r + 1) : r;
+    }
+  }
+  return wuffs_private_impl__csv__skip_field(p, q, delimiter);
+}
+
+// wuffs_base__csv_extract_f64_columns extracts the selected numeric columns
+// of src, CSV (RFC 4180) text, into dst's arrays. Fields are separated by
+// delimiter (typically ',', ';' or '\t') and records by "\n" or "\r\n".
+// Quoted fields may contain delimiters and newlines. Blank lines are skipped.
+// Any header row should be sliced off src by the caller.
+//
+// Each selected field is converted as it is scanned: the parser finds where
+// the number ends, and that must be where the field ends. Unselected fields
+// are skipped without conversion and, once all of a record's selected
+// columns are done, the rest of the record is skipped with memchr.
+//
+// options are passed on to the number parser. The
+// WUFFS_BASE__PARSE_NUMBER_FXX__DECIMAL_SEPARATOR_IS_A_COMMA option should
+// not be combined with a ',' delimiter.
+static WUFFS_BASE__POTENTIALLY_UNUSED
+wuffs_base__csv_extract_f64_columns__output  //
+wuffs_base__csv_extract_f64_columns(const wuffs_base__csv_columns* dst,
+                                    wuffs_base__slice_u8 src,
+                                    uint8_t delimiter,
+                                    uint32_t options) {
+  wuffs_base__csv_extract_f64_columns__output ret;
+  ret.status.repr = NULL;
+  ret.num_rows = 0;
+  ret.num_bytes = 0;
+  if (!dst || ((dst->num_columns > 0) &&
+               (!dst->column_indexes || !dst->values))) {
+    ret.status.repr = wuffs_base__error__bad_argument;
+    return ret;
+  } else if ((delimiter == '"') || (delimiter == '\n') ||
+             (delimiter == '\r')) {
+    ret.status.repr = wuffs_base__error__bad_argument;
+    return ret;
+  }
+
+  // slots[c] is 1 + the k such that dst->column_indexes[k] == c, or 0 if
+  // column c isn't selected.
+  size_t slots[WUFFS_PRIVATE_IMPL__CSV__SLOT_TABLE_LEN] = {0};
+  size_t k;
+  for (k = 0; k < dst->num_columns; k++) {
+    if (dst->column_indexes[k] < WUFFS_PRIVATE_IMPL__CSV__SLOT_TABLE_LEN) {
+      slots[dst->column_indexes[k]] = k + 1;
+    }
+  }
+
+  const uint8_t* p = src.ptr;
+  const uint8_t* const q = src.ptr + src.len;
+  size_t row = 0;
+  while ((p < q) && (row < dst->capacity)) {
+    // Skip blank lines.
+    if (*p == '\n') {
+      p++;
+      continue;
+    } else if ((*p == '\r') && ((p + 1) < q) && (p[1] == '\n')) {
+      p += 2;
+      continue;
+    }
+
+    // Default every selected column to missing.
+    uint8_t bit = (uint8_t)(1u << (row & 7));
+    for (k = 0; k < dst->num_columns; k++) {
+      dst->values[k][row] = 0;
+      if (dst->validity) {
+        dst->validity[k][row >> 3] =
+            (row & 7) ? (uint8_t)(dst->validity[k][row >> 3] & ~bit) : 0;
+      }
+    }
+
+    size_t num_found = 0;
+    size_t column = 0;
+    while (true) {
+      size_t slot = 0;
+      if (column < WUFFS_PRIVATE_IMPL__CSV__SLOT_TABLE_LEN) {
+        slot = slots[column];
+      } else {
+        for (k = 0; k < dst->num_columns; k++) {
+          if (dst->column_indexes[k] == column) {
+            slot = k + 1;
+            break;
+          }
+        }
+      }
+
+      if (slot) {
+        bool ok = false;
+        p = wuffs_private_impl__csv__parse_field(
+            &dst->values[slot - 1][row], &ok, p, q, delimiter, options);
+        if (ok && dst->validity) {
+          dst->validity[slot - 1][row >> 3] |= bit;
+        }
+        num_found++;
+      } else {
+        p = wuffs_private_impl__csv__skip_field(p, q, delimiter);
+      }
+
+      if ((p < q) && (*p == delimiter)) {
+        p++;
+        column++;
+        if (num_found < dst->num_columns) {
+          continue;
+        }
+        // Skip the rest of the record. Unless it has quotes (which can hide
+        // newlines), that's just finding the next '\n'.
+        const uint8_t* eol =
+            (const uint8_t*)memchr(p, '\n', (size_t)(q - p));
+        if (!eol) {
+          eol = q;
+        }
+        if (!memchr(p, '"', (size_t)(eol - p))) {
+          p = eol;
+        } else {
+          while (true) {
+            p = wuffs_private_impl__csv__skip_field(p, q, delimiter);
+            if ((p < q) && (*p == delimiter)) {
+              p++;
+              continue;
+            }
+            break;
+          }
+        }
+      }
+      break;
+    }
+
+    // We're at the end of the record.
+    if ((p < q) && (*p == '\n')) {
+      p++;
+    }
+    row++;
+  }
+
+  ret.num_rows = row;
+  ret.num_bytes = (size_t)(p - src.ptr);
+  return ret;
+}
+
+// ---------------- JSON
+
+// wuffs_base__json_extract_f64_array__output is the result of
+// wuffs_base__json_extract_f64_array.
+typedef struct wuffs_base__json_extract_f64_array__output__struct {
+  wuffs_base__status status;
+  // num_values is how many numbers the array holds (or, on a syntax error,
+  // held before the error). It can exceed dst_len: see below.
+  size_t num_values;
+  // num_bytes is how many bytes of src were consumed: up to and including
+  // the array's closing ']' or, on a syntax error, up to the error.
+  size_t num_bytes;
+} wuffs_base__json_extract_f64_array__output;
+
+// wuffs_private_impl__json__skip_whitespace returns a pointer to the first
+// byte in [p .. q) that isn't JSON whitespace, or q.
+static inline const uint8_t*  //
+wuffs_private_impl__json__skip_whitespace(const uint8_t* p, const uint8_t* q) {
+  // Compact JSON has no whitespace, and every byte that is whitespace is at
+  // or below ' ', so one comparison usually suffices.
+  if ((p < q) && (*p > ' ')) {
+    return p;
+  }
+#if defined(WUFFS_BASE__CPU_ARCH__X86_FAMILY)
+  // Pretty-printed JSON has runs of indentation. Skip 16 bytes at a time.
+  // SSE2 is part of x86_64, so this doesn't need run time CPU detection.
+  while ((q - p) >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(const void*)p);
+    __m128i ws = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))));
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(ws);
+    if (mask != 0xFFFF) {
+      return p + wuffs_base__count_trailing_zeroes_u64(~mask);
+    }
+    p += 16;
+  }
+#endif
+  for (; (p < q) &&
+         ((*p == ' ') || (*p == '\n') || (*p == '\r') || (*p == '\t'));
+       p++) {
+  }
+  return p;
+}
+
+// wuffs_private_impl__json__is_number returns whether the number [p .. end),
+// which wuffs_base__parse_number_f64_prefix (with zero options) accepted and
+// which starts with '-' or a digit, also follows the stricter JSON grammar.
+// The two grammars differ in two ways, checked here without re-walking every
+// digit:
+//  - Wuffs accepts a '.' without digits after it, as in "1." or "1.e5".
+//  - For "01", the prefix parser stops after the '0', so the '1' that is not
+//    allowed to follow it is just past end (but before q, src's end).
+static inline bool  //
+wuffs_private_impl__json__is_number(const uint8_t* p,
+                                    const uint8_t* end,
+                                    const uint8_t* q) {
+  if (*p == '-') {
+    p++;
+  }
+  if (*p == '0') {
+    p++;
+    if ((p < q) && wuffs_private_impl__is_decimal_digit(*p)) {
+      return false;
+    }
+  } else {
+    for (; (p < end) && wuffs_private_impl__is_decimal_digit(*p); p++) {
+    }
+  }
+  if ((p < end) && (*p == '.')) {
+    p++;
+    return (p < end) && wuffs_private_impl__is_decimal_digit(*p);
+  }
+  return true;
+}
+
+// wuffs_base__json_extract_f64_array parses src, which should start (after
+// optional whitespace) with a JSON array whose elements are numbers or,
+// recursively, such arrays. For example, "[1.25, 3.5e-3]" or GeoJSON-style
+// coordinates like "[[[-65.6, 43.4], [-65.7, 43.5]]]". It writes every
+// number, in document order, to dst, without building a DOM. Any bytes after
+// the array's closing ']' are not examined.
+//
+// If the array holds more than dst_len numbers, the first dst_len are
+// written, the rest are still validated and counted in num_values and the
+// status is wuffs_base__error__bad_argument_length_too_short. Passing a
+// dst_len of zero therefore counts the numbers (for sizing dst) without
+// writing any.
+//
+// Numbers must follow the strict JSON grammar: no leading '+', "Infinity",
+// "NaN" or redundant leading zeroes, and digits on both sides of any '.'.
+static WUFFS_BASE__POTENTIALLY_UNUSED
+wuffs_base__json_extract_f64_array__output  //
+wuffs_base__json_extract_f64_array(double* dst,
+                                   size_t dst_len,
+                                   wuffs_base__slice_u8 src) {
+  wuffs_base__json_extract_f64_array__output ret;
+  ret.status.repr = NULL;
+  ret.num_values = 0;
+
+  const uint8_t* p = wuffs_private_impl__json__skip_whitespace(
+      src.ptr, src.ptr + src.len);
+  const uint8_t* const q = src.ptr + src.len;
+  size_t depth = 0;
+  if ((p >= q) || (*p != '[')) {
+    goto fail;
+  }
+
+  while (true) {
+    // Expect a value: an array or a number.
+    p = wuffs_private_impl__json__skip_whitespace(p, q);
+    if (p >= q) {
+      goto fail;
+    } else if (*p == '[') {
+      p++;
+      depth++;
+      p = wuffs_private_impl__json__skip_whitespace(p, q);
+      if ((p < q) && (*p == ']')) {
+        p++;
+        depth--;
+        goto after_value;
+      }
+      continue;
+    } else if ((*p != '-') && !wuffs_private_impl__is_decimal_digit(*p)) {
+      goto fail;
+    }
+
+    do {
+      const uint8_t* d = p + ((*p == '-') ? 1 : 0);
+      if ((d >= q) || !wuffs_private_impl__is_decimal_digit(*d)) {
+        goto fail;
+      }
+      wuffs_base__slice_u8 s;
+      s.ptr = (uint8_t*)p;
+      s.len = (size_t)(q - p);
+      wuffs_base__parse_number_f64_prefix__output o =
+          wuffs_base__parse_number_f64_prefix(s, 0);
+      // The JSON grammar is stricter than Wuffs' (e.g. "1.e5" or "01").
+      if (o.status.repr ||
+          !wuffs_private_impl__json__is_number(p, p + o.num_bytes, q)) {
+        goto fail;
+      }
+      p += o.num_bytes;
+      if (ret.num_values < dst_len) {
+        dst[ret.num_values] = o.value;
+      }
+      ret.num_values++;
+    } while (0);
+
+  after_value:
+    // Expect a ',' or a ']'.
+    while (depth > 0) {
+      p = wuffs_private_impl__json__skip_whitespace(p, q);
+      if (p >= q) {
+        goto fail;
+      } else if (*p == ']') {
+        p++;
+        depth--;
+        continue;
+      } else if (*p == ',') {
+        p++;
+        break;
+      }
+      goto fail;
+    }
+    if (depth == 0) {
+      break;
+    }
+  }
+
+  if (ret.num_values > dst_len) {
+    ret.status.repr = wuffs_base__error__bad_argument_length_too_short;
+  }
+  ret.num_bytes = (size_t)(p - src.ptr);
+  return ret;
+
+fail:
+  ret.status.repr = wuffs_base__error__bad_argument;
+  ret.num_bytes = (size_t)(((p < q) ? p : q) - src.ptr);
+  return ret;
+}
@@ -0,0 +1,750 @@
+#pragma once
+
+// This file adds multi-threaded drivers on top of wuffs_eisel_lemire.c. It is
+// separate so that the core parser doesn't need POSIX threads. Link with
+// -pthread.
+
+// clock_gettime and CLOCK_MONOTONIC are POSIX, not ISO C, so a strict mode
+// like "cc -std=c11" hides them unless asked for. This only takes effect if
+// this file is #include'd before any system header.
+#if !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "wuffs_eisel_lemire.c"
+
+// ---------------- Work Stealing Scheduler
+
+// WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS caps the number of threads,
+// including the calling thread.
+#define WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS 256
+
+// wuffs_private_impl__parallel__worker is one thread's queue: the chunk
+// indexes [next .. end). The owner and thieves alike claim a chunk by
+// atomically incrementing next, so every chunk is claimed exactly once, but
+// the owner usually works through contiguous (cache- and prefetch-friendly)
+// chunks. It's padded to a cache line so that workers don't false-share.
+typedef struct wuffs_private_impl__parallel__worker__struct {
+  size_t next;
+  size_t end;
+  uint8_t padding[64 - (2 * sizeof(size_t))];
+} wuffs_private_impl__parallel__worker;
+
+typedef struct wuffs_private_impl__parallel__job__struct {
+  // The chunk_fn callback does chunk i's work.
+  void (*chunk_fn)(struct wuffs_private_impl__parallel__job__struct* job,
+                   size_t i);
+  void* context;
+
+  wuffs_private_impl__parallel__worker* workers;
+  size_t num_workers;
+} wuffs_private_impl__parallel__job;
+
+typedef struct wuffs_private_impl__parallel__thread_arg__struct {
+  wuffs_private_impl__parallel__job* job;
+  size_t worker_index;
+} wuffs_private_impl__parallel__thread_arg;
+
+// wuffs_private_impl__parallel__claim returns a chunk index claimed from
+// worker w's queue, or SIZE_MAX if that queue is empty.
+static inline size_t  //
+wuffs_private_impl__parallel__claim(wuffs_private_impl__parallel__worker* w) {
+  // Check first (a plain load) so that a drained queue isn't hammered with
+  // read-modify-write operations by every thief.
+  if (__atomic_load_n(&w->next, __ATOMIC_RELAXED) >= w->end) {
+    return SIZE_MAX;
+  }
+  size_t i = __atomic_fetch_add(&w->next, 1, __ATOMIC_RELAXED);
+  return (i < w->end) ? i : SIZE_MAX;
+}
+
+static void*  //
+wuffs_private_impl__parallel__run_worker(void* arg) {
+  wuffs_private_impl__parallel__thread_arg* a =
+      (wuffs_private_impl__parallel__thread_arg*)arg;
+  wuffs_private_impl__parallel__job* job = a->job;
+  size_t n = job->num_workers;
+
+  // Drain our own queue, then steal from the others, starting with our
+  // neighbor so that thieves spread out over the victims.
+  size_t k;
+  for (k = 0; k < n; k++) {
+    wuffs_private_impl__parallel__worker* w =
+        &job->workers[(a->worker_index + k) % n];
+    size_t i;
+    while ((i = wuffs_private_impl__parallel__claim(w)) != SIZE_MAX) {
+      (*job->chunk_fn)(job, i);
+    }
+  }
+  return NULL;
+}
+
+// wuffs_private_impl__parallel__run calls job->chunk_fn for every chunk index
+// in [0 .. num_chunks), on up to num_threads threads (including the calling
+// thread), and returns when they have all finished. If a thread can't be
+// created, its queue is stolen by the threads that were.
+static void  //
+wuffs_private_impl__parallel__run(wuffs_private_impl__parallel__job* job,
+                                  size_t num_chunks,
+                                  size_t num_threads) {
+  wuffs_private_impl__parallel__worker
+      workers[WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS];
+  wuffs_private_impl__parallel__thread_arg
+      args[WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS];
+  pthread_t threads[WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS];
+  bool started[WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS];
+
+  if (num_threads > num_chunks) {
+    num_threads = num_chunks;
+  }
+  if (num_threads == 0) {
+    return;
+  }
+
+  // Give each worker an equal, contiguous share of the chunks.
+  size_t t;
+  for (t = 0; t < num_threads; t++) {
+    workers[t].next = (num_chunks * t) / num_threads;
+    workers[t].end = (num_chunks * (t + 1)) / num_threads;
+    args[t].job = job;
+    args[t].worker_index = t;
+  }
+  job->workers = workers;
+  job->num_workers = num_threads;
+
+  for (t = 1; t < num_threads; t++) {
+    started[t] = pthread_create(&threads[t], NULL,
+                                &wuffs_private_impl__parallel__run_worker,
+                                &args[t]) == 0;
+  }
+  wuffs_private_impl__parallel__run_worker(&args[0]);
+  for (t = 1; t < num_threads; t++) {
+    if (started[t]) {
+      pthread_join(threads[t], NULL);
+    }
+  }
+}
+
+// wuffs_private_impl__parallel__default_num_threads returns the number of
+// online CPUs, clamped to [1 ..= WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS].
+static size_t  //
+wuffs_private_impl__parallel__default_num_threads(void) {
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n < 1) {
+    return 1;
+  } else if (n > WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS) {
+    return WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS;
+  }
+  return (size_t)n;
+}
+
+// ---------------- Parallel Line Parsing
+
+typedef struct wuffs_private_impl__parallel_lines__context__struct {
+  double* dst;
+  const uint8_t* src_ptr;
+  uint32_t options;
+
+  // Chunk i is the bytes [starts[i] .. starts[i + 1]) of src. Each start
+  // (other than the first) is just after a '\n', so that no line straddles
+  // two chunks. offsets[i] is where chunk i's first value goes in dst, and
+  // errors[i] is how many of chunk i's values failed to parse.
+  size_t* starts;
+  size_t* offsets;
+  size_t* errors;
+} wuffs_private_impl__parallel_lines__context;
+
+static void  //
+wuffs_private_impl__parallel_lines__count_chunk(
+    wuffs_private_impl__parallel__job* job,
+    size_t i) {
+  wuffs_private_impl__parallel_lines__context* c =
+      (wuffs_private_impl__parallel_lines__context*)job->context;
+  wuffs_base__slice_u8 s;
+  s.ptr = (uint8_t*)(c->src_ptr + c->starts[i]);
+  s.len = c->starts[i + 1] - c->starts[i];
+  // offsets[i + 1] holds the count for now. The caller turns the counts into
+  // a prefix sum.
+  c->offsets[i + 1] = wuffs_base__count_number_lines(s);
+}
+
+static void  //
+wuffs_private_impl__parallel_lines__parse_chunk(
+    wuffs_private_impl__parallel__job* job,
+    size_t i) {
+  wuffs_private_impl__parallel_lines__context* c =
+      (wuffs_private_impl__parallel_lines__context*)job->context;
+  wuffs_base__slice_u8 s;
+  s.ptr = (uint8_t*)(c->src_ptr + c->starts[i]);
+  s.len = c->starts[i + 1] - c->starts[i];
+  wuffs_base__parse_number_f64_lines__output o =
+      wuffs_base__parse_number_f64_lines(&c->dst[c->offsets[i]],
+                                         c->offsets[i + 1] - c->offsets[i], s,
+                                         c->options);
+  c->errors[i] = o.num_errors;
+}
+
+// wuffs_base__parse_number_f64_lines__parallel__output is the result of
+// wuffs_base__parse_number_f64_lines__parallel.
+typedef struct wuffs_base__parse_number_f64_lines__parallel__output__struct {
+  wuffs_base__status status;
+  size_t num_values;
+  size_t num_errors;
+} wuffs_base__parse_number_f64_lines__parallel__output;
+
+// wuffs_base__parse_number_f64_lines__parallel is like
+// wuffs_base__parse_number_f64_lines but uses multiple threads and always
+// consumes all of src. Its output, dst[0 .. num_values), is in the same order
+// and has the same values as the single-threaded version.
+//
+// num_threads includes the calling thread. Zero means one per online CPU.
+//
+// It works in two passes, each spread over the threads. The first counts each
+// chunk's lines, which gives (by prefix sum) every chunk's offset in dst. The
+// second parses each chunk in place, straight into dst. Chunks are small
+// relative to the whole of src (there are several per thread), and idle
+// threads steal them from busy ones, so that chunks with many slow-path
+// inputs don't leave the other threads waiting.
+//
+// If dst_len is less than the number of values (see
+// wuffs_base__count_number_lines), the status is
+// wuffs_base__error__bad_argument_length_too_short, num_values is the number
+// of values needed and dst is not written to.
+static WUFFS_BASE__POTENTIALLY_UNUSED
+wuffs_base__parse_number_f64_lines__parallel__output  //
+wuffs_base__parse_number_f64_lines__parallel(double* dst,
+                                             size_t dst_len,
+                                             wuffs_base__slice_u8 src,
+                                             uint32_t options,
+                                             uint32_t num_threads) {
+  wuffs_base__parse_number_f64_lines__parallel__output ret;
+  ret.status.repr = NULL;
+  ret.num_values = 0;
+  ret.num_errors = 0;
+
+  size_t nt = num_threads
+                  ? num_threads
+                  : wuffs_private_impl__parallel__default_num_threads();
+  if (nt > WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS) {
+    nt = WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS;
+  }
+
+  // Aim for 8 chunks per thread, each between 64 KiB and 16 MiB.
+  size_t chunk_len = src.len / (8 * nt);
+  if (chunk_len < 0x10000) {
+    chunk_len = 0x10000;
+  } else if (chunk_len > 0x1000000) {
+    chunk_len = 0x1000000;
+  }
+  size_t max_chunks = (src.len / chunk_len) + 1;
+
+  size_t* arrays = (size_t*)malloc(3 * (max_chunks + 1) * sizeof(size_t));
+  if (!arrays) {
+    // Without the scratch space, fall back to a single thread.
+    size_t n = wuffs_base__count_number_lines(src);
+    ret.num_values = n;
+    if (n > dst_len) {
+      ret.status.repr = wuffs_base__error__bad_argument_length_too_short;
+      return ret;
+    }
+    ret.num_errors =
+        wuffs_base__parse_number_f64_lines(dst, n, src, options).num_errors;
+    return ret;
+  }
+
+  wuffs_private_impl__parallel_lines__context c;
+  c.dst = dst;
+  c.src_ptr = src.ptr;
+  c.options = options;
+  c.starts = arrays;
+  c.offsets = arrays + (max_chunks + 1);
+  c.errors = arrays + (2 * (max_chunks + 1));
+
+  // Find the chunk boundaries: the nominal start, rounded up to just after
+  // the next '\n'.
+  size_t num_chunks = 0;
+  size_t pos = 0;
+  c.starts[0] = 0;
+  while (pos < src.len) {
+    size_t next = pos + chunk_len;
+    if (next >= src.len) {
+      next = src.len;
+    } else {
+      const uint8_t* eol = (const uint8_t*)memchr(src.ptr + next - 1, '\n',
+                                                  src.len - (next - 1));
+      next = eol ? ((size_t)(eol - src.ptr) + 1) : src.len;
+    }
+    c.starts[++num_chunks] = next;
+    pos = next;
+  }
+
+  wuffs_private_impl__parallel__job job;
+  job.context = &c;
+
+  // Pass 1: count, then prefix sum.
+  c.offsets[0] = 0;
+  job.chunk_fn = &wuffs_private_impl__parallel_lines__count_chunk;
+  wuffs_private_impl__parallel__run(&job, num_chunks, nt);
+  size_t i;
+  for (i = 0; i < num_chunks; i++) {
+    c.offsets[i + 1] += c.offsets[i];
+  }
+  ret.num_values = c.offsets[num_chunks];
+  if (ret.num_values > dst_len) {
+    ret.status.repr = wuffs_base__error__bad_argument_length_too_short;
+    free(arrays);
+    return ret;
+  }
+
+  // Pass 2: parse.
+  job.chunk_fn = &wuffs_private_impl__parallel_lines__parse_chunk;
+  wuffs_private_impl__parallel__run(&job, num_chunks, nt);
+  for (i = 0; i < num_chunks; i++) {
+    ret.num_errors += c.errors[i];
+  }
+
+  free(arrays);
+  return ret;
+}
+
+// ---------------- Pipelined Line Parsing
+
+const char wuffs_base__error__line_too_long[] = "#base: line too long";
+const char wuffs_base__error__out_of_memory[] = "#base: out of memory";
+const char wuffs_base__error__read_failed[] = "#base: read failed";
+
+// wuffs_private_impl__ring is a bounded, lock-free queue of size_t values,
+// after Dmitry Vyukov's bounded MPMC queue. Each cell's sequence number says
+// whether it is ready to be pushed to (sequence == pos) or popped from
+// (sequence == pos + 1), where pos is the push or pop position that maps to
+// that cell. Producers and consumers each claim a position with a
+// compare-and-swap, so that neither side ever takes a lock or waits for the
+// other side mid-operation.
+//
+// The pipeline uses two: a single-producer, multi-consumer ring of filled
+// buffers (from the reader to the parsers) and a multi-producer,
+// single-consumer ring of free buffers (from the parsers back to the reader).
+typedef struct wuffs_private_impl__ring__cell__struct {
+  size_t sequence;
+  size_t value;
+} wuffs_private_impl__ring__cell;
+
+typedef struct wuffs_private_impl__ring__struct {
+  wuffs_private_impl__ring__cell* cells;
+  size_t mask;
+  uint8_t padding0[64 - sizeof(void*) - sizeof(size_t)];
+  size_t push_pos;
+  uint8_t padding1[64 - sizeof(size_t)];
+  size_t pop_pos;
+  uint8_t padding2[64 - sizeof(size_t)];
+} wuffs_private_impl__ring;
+
+// wuffs_private_impl__ring__initialize prepares r to hold up to (mask + 1)
+// values, where (mask + 1) is a power of 2 and cells has that many elements.
+static void  //
+wuffs_private_impl__ring__initialize(wuffs_private_impl__ring* r,
+                                     wuffs_private_impl__ring__cell* cells,
+                                     size_t mask) {
+  size_t i;
+  for (i = 0; i <= mask; i++) {
+    cells[i].sequence = i;
+    cells[i].value = 0;
+  }
+  r->cells = cells;
+  r->mask = mask;
+  r->push_pos = 0;
+  r->pop_pos = 0;
+}
+
+// wuffs_private_impl__ring__push returns false if r is full.
+static bool  //
+wuffs_private_impl__ring__push(wuffs_private_impl__ring* r, size_t value) {
+  size_t pos = __atomic_load_n(&r->push_pos, __ATOMIC_RELAXED);
+  wuffs_private_impl__ring__cell* c;
+  while (true) {
+    c = &r->cells[pos & r->mask];
+    size_t seq = __atomic_load_n(&c->sequence, __ATOMIC_ACQUIRE);
+    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n(&r->push_pos, &pos, pos + 1, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = __atomic_load_n(&r->push_pos, __ATOMIC_RELAXED);
+    }
+  }
+  c->value = value;
+  __atomic_store_n(&c->sequence, pos + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+// wuffs_private_impl__ring__pop returns false if r is empty.
+static bool  //
+wuffs_private_impl__ring__pop(wuffs_private_impl__ring* r, size_t* value) {
+  size_t pos = __atomic_load_n(&r->pop_pos, __ATOMIC_RELAXED);
+  wuffs_private_impl__ring__cell* c;
+  while (true) {
+    c = &r->cells[pos & r->mask];
+    size_t seq = __atomic_load_n(&c->sequence, __ATOMIC_ACQUIRE);
+    intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n(&r->pop_pos, &pos, pos + 1, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = __atomic_load_n(&r->pop_pos, __ATOMIC_RELAXED);
+    }
+  }
+  *value = c->value;
+  __atomic_store_n(&c->sequence, pos + r->mask + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+static uint64_t  //
+wuffs_private_impl__pipeline__now_ns(void) {
+  struct timespec ts;
+#if defined(CLOCK_MONOTONIC)
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+  // A system header was #include'd before this file (and so before the
+  // _POSIX_C_SOURCE definition above) in a strict mode. Fall back to C11's
+  // wall clock, which is good enough for the pipeline's counters.
+  timespec_get(&ts, TIME_UTC);
+#endif
+  return ((uint64_t)ts.tv_sec * 1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+// wuffs_private_impl__pipeline__pop_wait pops from r, spinning and then
+// yielding while it is empty. It adds the time spent waiting (if any) to
+// *wait_ns, so that the clock is only read when the pipeline stalls.
+static size_t  //
+wuffs_private_impl__pipeline__pop_wait(wuffs_private_impl__ring* r,
+                                       uint64_t* wait_ns) {
+  size_t value;
+  if (wuffs_private_impl__ring__pop(r, &value)) {
+    return value;
+  }
+  uint64_t start = wuffs_private_impl__pipeline__now_ns();
+  uint32_t spins = 0;
+  while (!wuffs_private_impl__ring__pop(r, &value)) {
+    if (spins < 64) {
+      spins++;
+    } else {
+      sched_yield();
+    }
+  }
+  *wait_ns += wuffs_private_impl__pipeline__now_ns() - start;
+  return value;
+}
+
+// wuffs_base__parse_number_f64_lines__pipeline__func is called by the
+// parser threads once per buffer, in no particular order (and possibly
+// concurrently), with that buffer's values. sequence is the buffer's 0-based
+// position in the input, which lets the callee put them back in order.
+typedef void (*wuffs_base__parse_number_f64_lines__pipeline__func)(
+    void* context,
+    uint64_t sequence,
+    const double* values,
+    size_t num_values,
+    size_t num_errors);
+
+// wuffs_base__parse_number_f64_lines__pipeline__counters says where the
+// time went, to show which stage is the bottleneck. The *_ns fields are in
+// nanoseconds, summed over all of that stage's threads.
+//
+// A high reader_stall_ns (the reader waiting for a free buffer, i.e. back
+// pressure) means that parsing is the bottleneck: add parser threads. A high
+// parser_idle_ns (parsers waiting for a filled buffer) means that reading is
+// the bottleneck.
+typedef struct wuffs_base__parse_number_f64_lines__pipeline__counters__struct {
+  uint64_t num_buffers;
+  uint64_t num_bytes;
+  uint64_t num_values;
+  uint64_t num_errors;
+
+  // reader_read_ns is the time spent in read(2) calls.
+  uint64_t reader_read_ns;
+  // reader_stall_ns is the time spent waiting for a free buffer.
+  uint64_t reader_stall_ns;
+  // parser_busy_ns is the time spent parsing and in the callback.
+  uint64_t parser_busy_ns;
+  // parser_idle_ns is the time spent waiting for a filled buffer.
+  uint64_t parser_idle_ns;
+} wuffs_base__parse_number_f64_lines__pipeline__counters;
+
+// wuffs_base__parse_number_f64_lines__pipeline__output is the result of
+// wuffs_base__parse_number_f64_lines__pipeline.
+typedef struct wuffs_base__parse_number_f64_lines__pipeline__output__struct {
+  wuffs_base__status status;
+  wuffs_base__parse_number_f64_lines__pipeline__counters counters;
+} wuffs_base__parse_number_f64_lines__pipeline__output;
+
+// WUFFS_PRIVATE_IMPL__PIPELINE__END is a filled-ring value that tells a
+// parser thread to exit.
+#define WUFFS_PRIVATE_IMPL__PIPELINE__END SIZE_MAX
+
+typedef struct wuffs_private_impl__pipeline__context__struct {
+  wuffs_private_impl__ring filled;
+  wuffs_private_impl__ring free;
+
+  uint8_t* buffers;
+  size_t buffer_len;
+  // lengths[b] and sequences[b] describe the filled part of buffer b.
+  size_t* lengths;
+  uint64_t* sequences;
+
+  uint32_t options;
+  wuffs_base__parse_number_f64_lines__pipeline__func func;
+  void* func_context;
+} wuffs_private_impl__pipeline__context;
+
+typedef struct wuffs_private_impl__pipeline__parser__struct {
+  wuffs_private_impl__pipeline__context* c;
+  // dst has room for every value in a full buffer.
+  double* dst;
+  size_t dst_len;
+  wuffs_base__parse_number_f64_lines__pipeline__counters counters;
+} wuffs_private_impl__pipeline__parser;
+
+static void*  //
+wuffs_private_impl__pipeline__run_parser(void* arg) {
+  wuffs_private_impl__pipeline__parser* a =
+      (wuffs_private_impl__pipeline__parser*)arg;
+  wuffs_private_impl__pipeline__context* c = a->c;
+  while (true) {
+    size_t b = wuffs_private_impl__pipeline__pop_wait(
+        &c->filled, &a->counters.parser_idle_ns);
+    if (b == WUFFS_PRIVATE_IMPL__PIPELINE__END) {
+      break;
+    }
+    uint64_t start = wuffs_private_impl__pipeline__now_ns();
+    wuffs_base__slice_u8 s;
+    s.ptr = c->buffers + (b * c->buffer_len);
+    s.len = c->lengths[b];
+    wuffs_base__parse_number_f64_lines__output o =
+        wuffs_base__parse_number_f64_lines(a->dst, a->dst_len, s, c->options);
+    (*c->func)(c->func_context, c->sequences[b], a->dst, o.num_values,
+               o.num_errors);
+    a->counters.parser_busy_ns +=
+        wuffs_private_impl__pipeline__now_ns() - start;
+    a->counters.num_buffers++;
+    a->counters.num_bytes += s.len;
+    a->counters.num_values += o.num_values;
+    a->counters.num_errors += o.num_errors;
+    // The free ring has room for every buffer, so this can't fail.
+    wuffs_private_impl__ring__push(&c->free, b);
+  }
+  return NULL;
+}
+
+// wuffs_base__parse_number_f64_lines__pipeline reads newline-delimited
+// numbers from fd until end of file, overlapping the I/O with the parsing.
+// The calling thread is the reader: it fills buffers with read(2) and passes
+// them, through a lock-free ring, to num_parser_threads parser threads. Each
+// parser runs wuffs_base__parse_number_f64_lines over a buffer, calls func
+// with the values and then recycles the buffer through a second ring.
+//
+// Each buffer (other than the last) is cut just after its last '\n'. The
+// partial line after that is copied to the start of the next buffer, so that
+// every buffer can be parsed independently. Each line, including its '\n',
+// must fit in buffer_len bytes.
+//
+// There are num_buffers buffers. When all of them are in use (filled and
+// waiting, or being parsed) the reader waits for one to be recycled, which
+// bounds the memory used however slow the parsers are.
+//
+// Zero for num_parser_threads, buffer_len or num_buffers means a default:
+// one parser thread per online CPU (less one for the reader, but at least
+// one), 1 MiB and twice the number of parser threads (but at least 4). There
+// are always at least 2 buffers.
+static WUFFS_BASE__POTENTIALLY_UNUSED
+wuffs_base__parse_number_f64_lines__pipeline__output  //
+wuffs_base__parse_number_f64_lines__pipeline(
+    int fd,
+    uint32_t options,
+    wuffs_base__parse_number_f64_lines__pipeline__func func,
+    void* func_context,
+    uint32_t num_parser_threads,
+    size_t buffer_len,
+    size_t num_buffers) {
+  wuffs_base__parse_number_f64_lines__pipeline__output ret;
+  memset(&ret, 0, sizeof(ret));
+
+  size_t nt = num_parser_threads;
+  if (nt == 0) {
+    nt = wuffs_private_impl__parallel__default_num_threads();
+    nt = (nt > 1) ? (nt - 1) : 1;
+  } else if (nt > WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS) {
+    nt = WUFFS_PRIVATE_IMPL__PARALLEL__MAX_THREADS;
+  }
+  if (buffer_len == 0) {
+    buffer_len = 0x100000;
+  }
+  if (num_buffers == 0) {
+    num_buffers = (2 * nt > 4) ? (2 * nt) : 4;
+  } else if (num_buffers < 2) {
+    // The reader needs the next buffer (for the carry) before it can hand
+    // off the current one.
+    num_buffers = 2;
+  }
+
+  // The filled ring also holds the nt END values.
+  size_t ring_len = 1;
+  while (ring_len < (num_buffers + nt)) {
+    ring_len <<= 1;
+  }
+
+  // Every value takes at least 2 bytes (a digit and a '\n'), other than in
+  // a final line without a '\n'.
+  size_t dst_len = (buffer_len / 2) + 1;
+
+  wuffs_private_impl__pipeline__context c;
+  c.buffer_len = buffer_len;
+  c.options = options;
+  c.func = func;
+  c.func_context = func_context;
+  c.buffers = (uint8_t*)malloc(num_buffers * buffer_len);
+  c.lengths = (size_t*)malloc(num_buffers * sizeof(size_t));
+  c.sequences = (uint64_t*)malloc(num_buffers * sizeof(uint64_t));
+  wuffs_private_impl__ring__cell* cells =
+      (wuffs_private_impl__ring__cell*)malloc(
+          2 * ring_len * sizeof(wuffs_private_impl__ring__cell));
+  wuffs_private_impl__pipeline__parser* parsers =
+      (wuffs_private_impl__pipeline__parser*)calloc(
+          nt, sizeof(wuffs_private_impl__pipeline__parser));
+  pthread_t* threads = (pthread_t*)malloc(nt * sizeof(pthread_t));
+  double* dsts = (double*)malloc(nt * dst_len * sizeof(double));
+  // These are declared before the first "goto done", for C++'s sake.
+  size_t num_started = 0;
+  uint64_t sequence = 0;
+  size_t carry = 0;
+  if (!c.buffers || !c.lengths || !c.sequences || !cells || !parsers ||
+      !threads || !dsts) {
+    ret.status.repr = wuffs_base__error__out_of_memory;
+    goto done;
+  }
+
+  wuffs_private_impl__ring__initialize(&c.filled, cells, ring_len - 1);
+  wuffs_private_impl__ring__initialize(&c.free, cells + ring_len,
+                                       ring_len - 1);
+  size_t b;
+  for (b = 0; b < num_buffers; b++) {
+    wuffs_private_impl__ring__push(&c.free, b);
+  }
+
+  for (; num_started < nt; num_started++) {
+    wuffs_private_impl__pipeline__parser* a = &parsers[num_started];
+    a->c = &c;
+    a->dst = dsts + (num_started * dst_len);
+    a->dst_len = dst_len;
+    if (pthread_create(&threads[num_started], NULL,
+                       &wuffs_private_impl__pipeline__run_parser, a) != 0) {
+      break;
+    }
+  }
+  if (num_started == 0) {
+    ret.status.repr = wuffs_base__error__out_of_memory;
+    goto done;
+  }
+
+  // Read. The carry bytes, at the start of the current buffer, are a partial
+  // line left over from the previous buffer.
+  b = wuffs_private_impl__pipeline__pop_wait(&c.free,
+                                             &ret.counters.reader_stall_ns);
+  while (true) {
+    uint8_t* ptr = c.buffers + (b * buffer_len);
+    size_t len = carry;
+    bool eof = false;
+    uint64_t start = wuffs_private_impl__pipeline__now_ns();
+    while (len < buffer_len) {
+      ssize_t n = read(fd, ptr + len, buffer_len - len);
+      if (n > 0) {
+        len += (size_t)n;
+      } else if (n == 0) {
+        eof = true;
+        break;
+      } else if (errno != EINTR) {
+        ret.status.repr = wuffs_base__error__read_failed;
+        break;
+      }
+    }
+    ret.counters.reader_read_ns +=
+        wuffs_private_impl__pipeline__now_ns() - start;
+    if (ret.status.repr) {
+      break;
+    }
+
+    // Cut the buffer after its last '\n', unless this is the last buffer.
+    size_t cut = len;
+    if (!eof) {
+      while ((cut > 0) && (ptr[cut - 1] != '\n')) {
+        cut--;
+      }
+      if (cut == 0) {
+        ret.status.repr = wuffs_base__error__line_too_long;
+        break;
+      }
+    }
+
+    size_t next_b = 0;
+    if (!eof) {
+      next_b = wuffs_private_impl__pipeline__pop_wait(
+          &c.free, &ret.counters.reader_stall_ns);
+      carry = len - cut;
+      memcpy(c.buffers + (next_b * buffer_len), ptr + cut, carry);
+    }
+    if (cut > 0) {
+      c.lengths[b] = cut;
+      c.sequences[b] = sequence++;
+      wuffs_private_impl__ring__push(&c.filled, b);
+    } else {
+      wuffs_private_impl__ring__push(&c.free, b);
+    }
+    if (eof) {
+      break;
+    }
+    b = next_b;
+  }
+
+  // Stop the parsers. They finish any filled buffers first, since the END
+  // values are behind them in the ring.
+  size_t t;
+  for (t = 0; t < num_started; t++) {
+    wuffs_private_impl__ring__push(&c.filled,
+                                   WUFFS_PRIVATE_IMPL__PIPELINE__END);
+  }
+  for (t = 0; t < num_started; t++) {
+    pthread_join(threads[t], NULL);
+    wuffs_base__parse_number_f64_lines__pipeline__counters* pc =
+        &parsers[t].counters;
+    ret.counters.num_buffers += pc->num_buffers;
+    ret.counters.num_bytes += pc->num_bytes;
+    ret.counters.num_values += pc->num_values;
+    ret.counters.num_errors += pc->num_errors;
+    ret.counters.parser_busy_ns += pc->parser_busy_ns;
+    ret.counters.parser_idle_ns += pc->parser_idle_ns;
+  }
+
+done:
+  free(dsts);
+  free(threads);
+  free(parsers);
+  free(cells);
+  free(c.sequences);
+  free(c.lengths);
+  free(c.buffers);
+  return ret;
+}